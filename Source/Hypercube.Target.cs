@@ -9,6 +9,6 @@ public class HypercubeTarget : TargetRules
 	{
 		Type = TargetType.Game;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
-		ExtraModuleNames.Add("Hypercube");
+		ExtraModuleNames.AddRange(new string[] { "Hypercube", "HypercubeAllocHook" });
 	}
 }
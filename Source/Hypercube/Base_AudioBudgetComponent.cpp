@@ -0,0 +1,171 @@
+#include "Base_AudioBudgetComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Components/AudioComponent.h"
+#include "Sound/SoundBase.h"
+#include "GameFramework/Pawn.h"
+#include "HypercubeStats.h"
+
+UBase_AudioBudgetComponent::UBase_AudioBudgetComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+
+	NoticeBudget = { 2, 0.25f, 5000.0f, 0.15f, 2.0f };
+	FootstepBudget = { 6, 0.05f, 2500.0f, 0.05f, 1.5f };
+	DeathBudget = { 3, 0.1f, 5000.0f, 0.2f, 2.0f };
+
+	for (FCategoryState& State : States)
+	{
+		State.LastPlayTime = -1000.0f;
+		State.Stats = FSoundCategoryStats();
+	}
+}
+
+const FSoundCategoryBudget& UBase_AudioBudgetComponent::GetBudget(EEnemySoundCategory Category) const
+{
+	switch (Category)
+	{
+	case EEnemySoundCategory::Notice:
+		return NoticeBudget;
+	case EEnemySoundCategory::Footstep:
+		return FootstepBudget;
+	default:
+		return DeathBudget;
+	}
+}
+
+void UBase_AudioBudgetComponent::RequestSound(EEnemySoundCategory Category, class USoundBase* Sound, FVector Location)
+{
+	if (!Sound || Category >= EEnemySoundCategory::Count)
+	{
+		return;
+	}
+	States[int(Category)].Requests.Add({ Sound, Location });
+	if (!IsComponentTickEnabled())
+	{
+		SetComponentTickEnabled(true);
+	}
+}
+
+void UBase_AudioBudgetComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	GAMEPLAY_SYSTEM_SCOPE(Audio);
+	APawn* Listener = UGameplayStatics::GetPlayerPawn(this, 0);
+	FVector ListenerLocation = Listener ? Listener->GetActorLocation() : FVector::ZeroVector;
+	for (int i = 0; i < int(EEnemySoundCategory::Count); ++i)
+	{
+		if (States[i].Requests.Num())
+		{
+			FlushCategory(EEnemySoundCategory(i), ListenerLocation);
+		}
+	}
+	SetComponentTickEnabled(false);
+}
+
+void UBase_AudioBudgetComponent::FlushCategory(EEnemySoundCategory Category, const FVector& ListenerLocation)
+{
+	FCategoryState& State = States[int(Category)];
+	const FSoundCategoryBudget& Budget = GetBudget(Category);
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	int Nearest = INDEX_NONE;
+	float NearestDistSq = FMath::Square(Budget.MaxDistance);
+	for (int i = 0; i < State.Requests.Num(); ++i)
+	{
+		float DistSq = FVector::DistSquared(State.Requests[i].Location, ListenerLocation);
+		if (DistSq <= NearestDistSq)
+		{
+			Nearest = i;
+			NearestDistSq = DistSq;
+		}
+	}
+	int RequestCount = State.Requests.Num();
+	if (Nearest == INDEX_NONE || Now - State.LastPlayTime < Budget.MinInterval)
+	{
+		State.Stats.Dropped += RequestCount;
+		State.Requests.Reset();
+		return;
+	}
+	const FSoundRequest Request = State.Requests[Nearest];
+	State.Requests.Reset();
+
+	State.Voices.RemoveAllSwap([](const FVoice& Voice)
+	{
+		return !Voice.Component.IsValid() || !Voice.Component->IsPlaying();
+	}, false);
+	if (State.Voices.Num() >= Budget.MaxVoices)
+	{
+		int Farthest = INDEX_NONE;
+		float FarthestDistSq = NearestDistSq;
+		for (int i = 0; i < State.Voices.Num(); ++i)
+		{
+			float DistSq = FVector::DistSquared(State.Voices[i].Location, ListenerLocation);
+			if (DistSq > FarthestDistSq)
+			{
+				Farthest = i;
+				FarthestDistSq = DistSq;
+			}
+		}
+		if (Farthest == INDEX_NONE)
+		{
+			State.Stats.Dropped += RequestCount;
+			return;
+		}
+		State.Voices[Farthest].Component->Stop();
+		State.Voices.RemoveAtSwap(Farthest, 1, false);
+		++State.Stats.Stolen;
+	}
+
+	float Volume = FMath::Min(1.0f + Budget.VolumePerMergedRequest * float(RequestCount - 1), Budget.MaxVolumeMultiplier);
+	UAudioComponent* Component = UGameplayStatics::SpawnSoundAtLocation(this, Request.Sound, Request.Location, FRotator::ZeroRotator, Volume);
+	if (Component)
+	{
+		State.Voices.Add({ Component, Request.Location });
+	}
+	State.LastPlayTime = Now;
+	++State.Stats.Played;
+	State.Stats.Merged += RequestCount - 1;
+}
+
+void UBase_AudioBudgetComponent::NoteExternalPlay(EEnemySoundCategory Category)
+{
+	if (Category < EEnemySoundCategory::Count)
+	{
+		FCategoryState& State = States[int(Category)];
+		State.LastPlayTime = GetWorld()->GetTimeSeconds();
+		++State.Stats.Played;
+	}
+}
+
+float UBase_AudioBudgetComponent::GetMinInterval(EEnemySoundCategory Category) const
+{
+	return GetBudget(Category).MinInterval;
+}
+
+FSoundCategoryStats UBase_AudioBudgetComponent::GetCategoryStats(EEnemySoundCategory Category) const
+{
+	return Category < EEnemySoundCategory::Count ? States[int(Category)].Stats : FSoundCategoryStats();
+}
+
+FSoundCategoryStats UBase_AudioBudgetComponent::GetTotalStats() const
+{
+	FSoundCategoryStats Total = FSoundCategoryStats();
+	for (const FCategoryState& State : States)
+	{
+		Total.Played += State.Stats.Played;
+		Total.Merged += State.Stats.Merged;
+		Total.Dropped += State.Stats.Dropped;
+		Total.Stolen += State.Stats.Stolen;
+	}
+	return Total;
+}
+
+void UBase_AudioBudgetComponent::ResetStats()
+{
+	for (FCategoryState& State : States)
+	{
+		State.Stats = FSoundCategoryStats();
+	}
+}
@@ -0,0 +1,122 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Base_AudioBudgetComponent.generated.h"
+
+UENUM(BlueprintType)
+enum class EEnemySoundCategory : uint8
+{
+	Notice UMETA(DisplayName = "Notice"),
+	Footstep UMETA(DisplayName = "Footstep"),
+	Death UMETA(DisplayName = "Death"),
+	Count UMETA(Hidden)
+};
+
+USTRUCT(BlueprintType)
+struct FSoundCategoryBudget
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int MaxVoices;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float MinInterval;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float MaxDistance;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float VolumePerMergedRequest;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float MaxVolumeMultiplier;
+};
+
+USTRUCT(BlueprintType)
+struct FSoundCategoryStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int Played;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int Merged;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int Dropped;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int Stolen;
+};
+
+// Voice budget for enemy sounds. Requests of one category made during a frame are merged into a single voice
+// at the request nearest to the player, louder the more requests were merged. Each category has its own voice limit;
+// when it is full, the new voice replaces the farthest playing one if it is nearer to the player, otherwise it is dropped.
+UCLASS(ClassGroup = (Audio), meta = (BlueprintSpawnableComponent))
+class HYPERCUBE_API UBase_AudioBudgetComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UBase_AudioBudgetComponent();
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Budget)
+	FSoundCategoryBudget NoticeBudget;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Budget)
+	FSoundCategoryBudget FootstepBudget;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Budget)
+	FSoundCategoryBudget DeathBudget;
+
+	UFUNCTION(BlueprintCallable)
+	void RequestSound(EEnemySoundCategory Category, class USoundBase* Sound, FVector Location);
+
+	// for sounds played outside the budget: counts as a voice of Category for its MinInterval
+	void NoteExternalPlay(EEnemySoundCategory Category);
+	float GetMinInterval(EEnemySoundCategory Category) const;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	FSoundCategoryStats GetCategoryStats(EEnemySoundCategory Category) const;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	FSoundCategoryStats GetTotalStats() const;
+
+	UFUNCTION(BlueprintCallable)
+	void ResetStats();
+
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+
+	struct FVoice
+	{
+		TWeakObjectPtr<class UAudioComponent> Component;
+		FVector Location;
+	};
+
+	struct FSoundRequest
+	{
+		class USoundBase* Sound;
+		FVector Location;
+	};
+
+	struct FCategoryState
+	{
+		TArray<FSoundRequest> Requests;
+		TArray<FVoice> Voices;
+		float LastPlayTime;
+		FSoundCategoryStats Stats;
+	};
+
+	FCategoryState States[int(EEnemySoundCategory::Count)];
+
+	const FSoundCategoryBudget& GetBudget(EEnemySoundCategory Category) const;
+	void FlushCategory(EEnemySoundCategory Category, const FVector& ListenerLocation);
+};
@@ -0,0 +1,213 @@
+#include "Base_BotComponent.h"
+#include "Base_LevelController.h"
+#include "Base_InputRecorderComponent.h"
+#include "HypercubeCharacter.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "NavigationSystem.h"
+#include "NavigationPath.h"
+#include "Misc/CommandLine.h"
+#include "HAL/PlatformTime.h"
+#include "TimerManager.h"
+#include "Hypercube.h"
+
+namespace
+{
+	int32 BotLevelsPlayed = 0; // survives level loads within one session
+}
+
+UBase_BotComponent::UBase_BotComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	AttackRange = 250.0f;
+	KiteRadius = 700.0f;
+	KiteEnemyCount = 5;
+	DashThreatRadius = 200.0f;
+	PathRefreshTime = 0.5f;
+	StuckTime = 1.5f;
+	NextLevelDelay = 2.0f;
+
+	Player = nullptr;
+	PlayerController = nullptr;
+	PathIndex = 0;
+	PathRefreshTimer = 0.0f;
+	StuckTimer = 0.0f;
+	LastFrameTime = 0.0;
+}
+
+bool UBase_BotComponent::IsRequested()
+{
+	return FParse::Param(FCommandLine::Get(), TEXT("HypercubeBot"));
+}
+
+void UBase_BotComponent::Start(class AHypercubeCharacter* NewPlayer, int32 Seed)
+{
+	Player = NewPlayer;
+	PlayerController = Cast<APlayerController>(Player->GetController());
+	if (PlayerController)
+	{
+		Player->DisableInput(PlayerController);
+		// the bot feeds input before the controller applies rotation, like a replay
+		PlayerController->PrimaryActorTick.AddPrerequisite(GetOwner(), PrimaryComponentTick);
+	}
+	Stream.Initialize(Seed);
+	FrameTimes.Reset();
+	FrameTimes.Reserve(60 * 60 * 5);
+	LastFrameTime = 0.0;
+	SetComponentTickEnabled(true);
+	UE_LOG(LogHypercube, Warning, TEXT("Bot started, level %d of the session"), BotLevelsPlayed + 1);
+}
+
+void UBase_BotComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	double Now = FPlatformTime::Seconds();
+	if (LastFrameTime > 0.0)
+	{
+		FrameTimes.Add(float((Now - LastFrameTime) * 1000.0));
+	}
+	LastFrameTime = Now;
+	if (Player && Player->Health > 0.0f)
+	{
+		Think(DeltaTime);
+	}
+}
+
+void UBase_BotComponent::Think(float DeltaTime)
+{
+	ABase_LevelController* LevelController = Cast<ABase_LevelController>(GetOwner());
+	FEnemyRegistry& Registry = LevelController->GetEnemyRegistry();
+	Registry.RefreshPositions();
+
+	const FVector Location = Player->GetActorLocation();
+	const float KiteRadiusSq = FMath::Square(KiteRadius);
+	FVector NearestPosition = FVector::ZeroVector;
+	float NearestDistSq = MAX_flt;
+	FVector Crowd = FVector::ZeroVector;
+	int CrowdCount = 0;
+	for (const FEnemyHotData& Enemy : Registry.GetAllHotData())
+	{
+		float DistSq = FVector::DistSquared2D(Enemy.Position, Location);
+		if (DistSq < NearestDistSq)
+		{
+			NearestDistSq = DistSq;
+			NearestPosition = Enemy.Position;
+		}
+		if (DistSq < KiteRadiusSq)
+		{
+			Crowd += Enemy.Position;
+			++CrowdCount;
+		}
+	}
+	if (NearestDistSq == MAX_flt)
+	{
+		return;
+	}
+
+	if (CrowdCount >= KiteEnemyCount)
+	{
+		FVector Away = Location - Crowd / float(CrowdCount);
+		Away.Z = 0.0f;
+		Away = Away.IsNearlyZero() ? Stream.GetUnitVector().GetSafeNormal2D() : Away.GetSafeNormal();
+		if (NearestDistSq < FMath::Square(DashThreatRadius))
+		{
+			Player->DashTowards(Away);
+		}
+		MoveAlong(Away);
+		return;
+	}
+	if (NearestDistSq < FMath::Square(AttackRange))
+	{
+		MoveAlong((NearestPosition - Location).GetSafeNormal2D());
+		Player->ReceiveAttackInput();
+		return;
+	}
+
+	MoveAlong(FollowPath(NearestPosition));
+	const bool bStuck = Player->GetVelocity().SizeSquared2D() < 100.0f;
+	StuckTimer = bStuck ? StuckTimer + DeltaTime : 0.0f;
+	if (StuckTimer > StuckTime)
+	{
+		StuckTimer = 0.0f;
+		PathPoints.Reset();
+		Player->DashTowards(Stream.GetUnitVector().GetSafeNormal2D());
+	}
+}
+
+FVector UBase_BotComponent::FollowPath(const FVector& Target)
+{
+	const FVector Location = Player->GetActorLocation();
+	PathRefreshTimer -= GetWorld()->GetDeltaSeconds();
+	if (PathRefreshTimer <= 0.0f || !PathPoints.IsValidIndex(PathIndex))
+	{
+		PathRefreshTimer = PathRefreshTime;
+		PathPoints.Reset();
+		PathIndex = 1;
+		UNavigationPath* Path = UNavigationSystemV1::FindPathToLocationSynchronously(this, Location, Target, Player);
+		if (Path && Path->IsValid())
+		{
+			PathPoints = Path->PathPoints;
+		}
+	}
+	while (PathPoints.IsValidIndex(PathIndex) && FVector::DistSquared2D(PathPoints[PathIndex], Location) < FMath::Square(100.0f))
+	{
+		++PathIndex;
+	}
+	const FVector Next = PathPoints.IsValidIndex(PathIndex) ? PathPoints[PathIndex] : Target;
+	return (Next - Location).GetSafeNormal2D();
+}
+
+void UBase_BotComponent::MoveAlong(const FVector& Direction)
+{
+	if (!PlayerController || Direction.IsNearlyZero())
+	{
+		return;
+	}
+	// the camera follows the control rotation, so turning it keeps "forward" pointing where the bot wants to go
+	PlayerController->SetControlRotation(FRotator(0.0f, Direction.Rotation().Yaw, 0.0f));
+	FInputFrame Frame = { { 1.0f, 0.0f, 0.0f, 0.0f }, 0 };
+	Player->ApplyReplayInput(Frame);
+}
+
+void UBase_BotComponent::OnLevelFinished(const FLevelData& Result)
+{
+	FLevelData Copy = Result;
+	UE_LOG(LogHypercube, Warning, TEXT("Bot level %d finished"), BotLevelsPlayed + 1);
+	Copy.Log();
+	LogFrameTimes();
+	SetComponentTickEnabled(false);
+	GetWorld()->GetTimerManager().SetTimer(NextLevelTimerHandle, this, &UBase_BotComponent::LoadNextLevel, NextLevelDelay, false);
+}
+
+void UBase_BotComponent::LogFrameTimes() const
+{
+	if (!FrameTimes.Num())
+	{
+		return;
+	}
+	TArray<float> Sorted = FrameTimes;
+	Sorted.Sort();
+	auto Percentile = [&Sorted](float P)
+	{
+		return Sorted[FMath::Clamp(FMath::CeilToInt(P * Sorted.Num()) - 1, 0, Sorted.Num() - 1)];
+	};
+	UE_LOG(LogHypercube, Warning, TEXT("Frame ms over %d frames: p50 %.2f, p90 %.2f, p99 %.2f, max %.2f"),
+		Sorted.Num(), Percentile(0.5f), Percentile(0.9f), Percentile(0.99f), Sorted.Last());
+}
+
+void UBase_BotComponent::LoadNextLevel()
+{
+	++BotLevelsPlayed;
+	ABase_LevelController* LevelController = Cast<ABase_LevelController>(GetOwner());
+	int32 MaxLevels = LevelController->LevelNames.Num();
+	FParse::Value(FCommandLine::Get(), TEXT("HypercubeBotLevels="), MaxLevels);
+	if (BotLevelsPlayed >= MaxLevels)
+	{
+		UE_LOG(LogHypercube, Warning, TEXT("Bot session finished after %d levels"), BotLevelsPlayed);
+		FPlatformMisc::RequestExit(false);
+		return;
+	}
+	LevelController->LoadNextLevel();
+}
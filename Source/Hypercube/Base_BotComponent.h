@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Base_RunDataSave.h"
+#include "Base_BotComponent.generated.h"
+
+// Plays the level in place of a human for soak tests, started by the level controller with -HypercubeBot
+// (-HypercubeBotLevels=N to stop after N levels, -nullrhi to run headless). It feeds the character through the same
+// input path as a replay: it chases the nearest enemy along the nav mesh, attacks in range, and kites with dashes
+// when too many enemies close in. Frame-time percentiles and the FLevelData of every level are logged.
+UCLASS()
+class HYPERCUBE_API UBase_BotComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UBase_BotComponent();
+
+	static bool IsRequested();
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot)
+	float AttackRange;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot)
+	float KiteRadius;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot)
+	int KiteEnemyCount;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot)
+	float DashThreatRadius;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot)
+	float PathRefreshTime;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot)
+	float StuckTime;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot)
+	float NextLevelDelay;
+
+	void Start(class AHypercubeCharacter* Player, int32 Seed);
+	void OnLevelFinished(const FLevelData& Result);
+
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+
+	class AHypercubeCharacter* Player;
+	class APlayerController* PlayerController;
+	FRandomStream Stream;
+
+	TArray<FVector> PathPoints;
+	int32 PathIndex;
+	float PathRefreshTimer;
+	float StuckTimer;
+
+	TArray<float> FrameTimes; // ms
+	double LastFrameTime;
+
+	FTimerHandle NextLevelTimerHandle;
+
+	void Think(float DeltaTime);
+	void MoveAlong(const FVector& Direction);
+	FVector FollowPath(const FVector& Target);
+	void LogFrameTimes() const;
+	void LoadNextLevel();
+};
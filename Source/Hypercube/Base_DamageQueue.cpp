@@ -0,0 +1,32 @@
+#include "Base_DamageQueue.h"
+#include "Base_NPC_SimpleChase.h"
+
+void FDamageQueue::Add(class ABase_NPC_SimpleChase* Enemy, float Damage)
+{
+	for (FQueuedDamage& Queued : Pending)
+	{
+		if (Queued.Enemy == Enemy)
+		{
+			Queued.Damage += Damage;
+			return;
+		}
+	}
+	Pending.Add({ Enemy, Damage });
+}
+
+bool FDamageQueue::IsEmpty() const
+{
+	return !Pending.Num();
+}
+
+void FDamageQueue::Resolve(FKilledEnemies& OutKilled)
+{
+	for (const FQueuedDamage& Queued : Pending)
+	{
+		if (IsValid(Queued.Enemy) && Queued.Enemy->ApplyDamage(Queued.Damage))
+		{
+			OutKilled.Add(Queued.Enemy);
+		}
+	}
+	Pending.Reset();
+}
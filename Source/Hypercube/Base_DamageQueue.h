@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FQueuedDamage
+{
+	class ABase_NPC_SimpleChase* Enemy;
+	float Damage;
+};
+
+// Hits the player lands during a frame. They are applied together in Resolve, so deaths and everything that follows
+// from them (score, vampirism, the damage multiplier, the controller's kill bookkeeping) run once per frame, not per hit.
+// Several hits on one enemy are summed into one.
+class HYPERCUBE_API FDamageQueue
+{
+public:
+
+	typedef TArray<class ABase_NPC_SimpleChase*, TInlineAllocator<32>> FKilledEnemies;
+
+	void Add(class ABase_NPC_SimpleChase* Enemy, float Damage);
+	bool IsEmpty() const;
+
+	// applies the queued damage and empties the queue, OutKilled gets the enemies this damage killed
+	void Resolve(FKilledEnemies& OutKilled);
+
+protected:
+
+	TArray<FQueuedDamage, TInlineAllocator<32>> Pending;
+};
@@ -0,0 +1,96 @@
+#include "Base_DifficultyCurve.h"
+#include "Algo/BinarySearch.h"
+#include "Templates/Greater.h"
+#include "HypercubeStats.h"
+#include "Hypercube.h"
+
+FDifficultyParams::FDifficultyParams()
+{
+	PlayerVelocity = PlayerDamageMultiplier = 1.0f;
+	PlayerVampirism = 0.0f;
+	EnemyVelocity = EnemyDamage = EnemyNoticeRadius = EnemyCountPercentage = 1.0f;
+}
+
+FDifficultyCurve::FDifficultyCurve()
+{
+	bBoundsAsc = bValuesAsc = bValid = false;
+}
+
+float FDifficultyCurve::Evaluate(float Val) const
+{
+	if (!bValid)
+	{
+		return 0.5f;
+	}
+	int Index = bBoundsAsc ? Algo::UpperBound(Bounds, Val) : Algo::UpperBound(Bounds, Val, TGreater<>());
+	if (Index < Bounds.Num())
+	{
+		return Values[Index];
+	}
+	return bValuesAsc ? 1.0f : 0.0f;
+}
+
+bool FDifficultyCurve::IsValid() const
+{
+	return bValid;
+}
+
+FDifficultyOutputTable::FDifficultyOutputTable()
+{
+	bValid = false;
+}
+
+bool FDifficultyOutputTable::Compile(const TArray<float>& InBounds)
+{
+	Bounds = InBounds;
+	bValid = Bounds.Num() > 0 && GetAsc(Bounds) == 1;
+	if (!bValid)
+	{
+		UE_LOG(LogHypercube, Error, TEXT("Adaptive difficulty: Bounds array must be monotone"));
+	}
+	return bValid;
+}
+
+int FDifficultyOutputTable::GetIndex(float Difficulty) const
+{
+	if (!bValid)
+	{
+		return -1;
+	}
+	return FMath::Clamp(Algo::UpperBound(Bounds, Difficulty) - 1, 0, Bounds.Num() - 1);
+}
+
+float FDifficultyOutputTable::GetValue(int Index, const TArray<float>& Values, float Default, const TCHAR* Name) const
+{
+	if (Values.Num() != Bounds.Num())
+	{
+		UE_LOG(LogHypercube, Error, TEXT("Adaptive difficulty: %s array must be the same length as bounds array!"), Name);
+		return Default;
+	}
+	return Values.IsValidIndex(Index) ? Values[Index] : Default;
+}
+
+bool FDifficultyOutputTable::IsValid() const
+{
+	return bValid;
+}
+
+FAdaptiveDifficultyModel::FAdaptiveDifficultyModel()
+{
+	DeathCountCost = OnDeathEnemyAggroCost = PlayTimeCost = 0.0f;
+}
+
+float FAdaptiveDifficultyModel::Evaluate(const FRunAggregates& Aggregates) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_Hypercube_DifficultyEvaluate);
+	GAMEPLAY_SYSTEM_SCOPE(Difficulty);
+	if (!Aggregates.TotalRuns)
+	{
+		return 0.5f;
+	}
+	bool IsWon = Aggregates.LastRun.PlayerWon;
+	float DeathCountParameter = DeathCountCurve.Evaluate(Aggregates.DeathStreak) * DeathCountCost;
+	float OnDeathChasingParameter = (IsWon ? 1.0f : OnDeathEnemyAggroCurve.Evaluate(Aggregates.LastRun.OnDeathEnemyChasing)) * OnDeathEnemyAggroCost;
+	float PlayTimeParameter = (IsWon ? 1.0f : PlayTimeCurve.Evaluate(Aggregates.LastRun.PlayTime)) * PlayTimeCost;
+	return DeathCountParameter + OnDeathChasingParameter + PlayTimeParameter;
+}
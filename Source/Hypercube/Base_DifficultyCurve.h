@@ -0,0 +1,153 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Base_RunDataSave.h"
+#include "Hypercube.h"
+#include "Base_DifficultyCurve.generated.h"
+
+USTRUCT(BlueprintType)
+struct FDifficultyParams
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float PlayerVelocity;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float PlayerDamageMultiplier;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float PlayerVampirism;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float EnemyVelocity;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float EnemyDamage;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float EnemyNoticeRadius;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float EnemyCountPercentage;
+
+	FDifficultyParams();
+};
+
+template<typename T>
+int GetAsc(const TArray<T>& Arr) // returns 1 when array is increasing, -1 when decreasing, else 0
+{
+	if (Arr.Num() < 2)
+	{
+		return 1;
+	}
+	bool Asc = Arr[0] < Arr.Last();
+	if (Asc)
+	{
+		for (int i = 0; i < Arr.Num() - 1; ++i)
+		{
+			if (Arr[i] > Arr[i + 1])
+			{
+				return 0;
+			}
+		}
+	}
+	else
+	{
+		for (int i = 0; i < Arr.Num() - 1; ++i)
+		{
+			if (Arr[i] < Arr[i + 1])
+			{
+				return 0;
+			}
+		}
+	}
+	return Asc ? 1 : -1;
+}
+
+// Maps an input statistic (death count, enemy aggro, play time) to an unscaled difficulty parameter.
+// Bounds and values are validated once in Compile, Evaluate is a binary search over the bounds.
+struct FDifficultyCurve
+{
+	FDifficultyCurve();
+
+	template<typename T>
+	bool Compile(const TArray<T>& InBounds, const TArray<float>& InValues);
+
+	float Evaluate(float Val) const;
+
+	bool IsValid() const;
+
+protected:
+
+	TArray<float> Bounds;
+	TArray<float> Values;
+	bool bBoundsAsc;
+	bool bValuesAsc;
+	bool bValid;
+};
+
+template<typename T>
+bool FDifficultyCurve::Compile(const TArray<T>& InBounds, const TArray<float>& InValues)
+{
+	bValid = false;
+	Bounds.Reset(InBounds.Num());
+	Values = InValues;
+	if (!InBounds.Num() || InBounds.Num() != InValues.Num())
+	{
+		UE_LOG(LogHypercube, Error, TEXT("Adaptive difficulty: Bounds array must be the same length as values array!"));
+		return false;
+	}
+	if (!GetAsc(InBounds) || !GetAsc(InValues))
+	{
+		UE_LOG(LogHypercube, Error, TEXT("Adaptive difficulty: Bounds and values arrays must be monotone"));
+		return false;
+	}
+	for (const T& Bound : InBounds)
+	{
+		Bounds.Add(float(Bound));
+	}
+	bBoundsAsc = Bounds[0] < Bounds.Last();
+	bValuesAsc = Values[0] < Values.Last();
+	bValid = true;
+	return true;
+}
+
+// Step table from the difficulty parameter to game parameters. Every output array shares the same bounds,
+// so the bucket is looked up once and then used as a direct index into each values array.
+struct FDifficultyOutputTable
+{
+	FDifficultyOutputTable();
+
+	bool Compile(const TArray<float>& InBounds);
+
+	int GetIndex(float Difficulty) const; // returns -1 when the table is invalid
+	float GetValue(int Index, const TArray<float>& Values, float Default, const TCHAR* Name) const;
+
+	bool IsValid() const;
+
+protected:
+
+	TArray<float> Bounds;
+	bool bValid;
+};
+
+// The whole adaptive difficulty computation without any world state, shared by the level controller and the simulator commandlet
+struct FAdaptiveDifficultyModel
+{
+	FAdaptiveDifficultyModel();
+
+	FDifficultyCurve DeathCountCurve;
+	FDifficultyCurve OnDeathEnemyAggroCurve;
+	FDifficultyCurve PlayTimeCurve;
+
+	float DeathCountCost;
+	float OnDeathEnemyAggroCost;
+	float PlayTimeCost;
+
+	FDifficultyOutputTable OutputTable;
+
+	float Evaluate(const FRunAggregates& Aggregates) const;
+};
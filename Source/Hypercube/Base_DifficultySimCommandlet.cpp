@@ -0,0 +1,321 @@
+#include "Base_DifficultySimCommandlet.h"
+#include "Base_LevelController.h"
+#include "Base_RunDataSave.h"
+#include "Async/ParallelFor.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Hypercube.h"
+
+namespace DifficultySim
+{
+	// Tracked tables: the difficulty parameter itself followed by every FDifficultyParams output
+	static const int NumTables = 8;
+	static const TCHAR* TableNames[NumTables] = {
+		TEXT("DifficultyParameter"),
+		TEXT("PlayerVelocityValues"),
+		TEXT("PlayerDamageMultiplerValues"),
+		TEXT("PlayerVampirismValues"),
+		TEXT("EnemyVelocityValues"),
+		TEXT("EnemyDamageValues"),
+		TEXT("EnemyNoticeRadiusValues"),
+		TEXT("EnemyCountPercentageValues")
+	};
+
+	struct FSettings
+	{
+		int Histories;
+		int Runs;
+		int Seed;
+		float Steepness;
+		float Epsilon;
+		int Window;
+		float RollingStatsWeight;
+	};
+
+	struct FAccumulator
+	{
+		int64 Histories;
+		int64 Wins;
+		double FinalSum;
+		double FinalSqSum;
+		double SignChangesSum;
+		int64 Converged[NumTables];
+		double ChangesSum[NumTables];
+		TArray<int64> ConvergedAt[NumTables]; // histogram over the run index of the last change
+
+		void Init(int Runs)
+		{
+			Histories = Wins = 0;
+			FinalSum = FinalSqSum = SignChangesSum = 0.0;
+			for (int t = 0; t < NumTables; ++t)
+			{
+				Converged[t] = 0;
+				ChangesSum[t] = 0.0;
+				ConvergedAt[t].Init(0, Runs);
+			}
+		}
+
+		void Merge(const FAccumulator& Other)
+		{
+			Histories += Other.Histories;
+			Wins += Other.Wins;
+			FinalSum += Other.FinalSum;
+			FinalSqSum += Other.FinalSqSum;
+			SignChangesSum += Other.SignChangesSum;
+			for (int t = 0; t < NumTables; ++t)
+			{
+				Converged[t] += Other.Converged[t];
+				ChangesSum[t] += Other.ChangesSum[t];
+				for (int i = 0; i < ConvergedAt[t].Num(); ++i)
+				{
+					ConvergedAt[t][i] += Other.ConvergedAt[t][i];
+				}
+			}
+		}
+	};
+
+	// Follows one difficulty trajectory and counts how often every table changes its value
+	struct FTrajectory
+	{
+		float Prev[NumTables];
+		int LastChange[NumTables];
+		int Changes[NumTables];
+		int PrevSign;
+		int SignChanges;
+		int Steps;
+
+		FTrajectory()
+		{
+			for (int t = 0; t < NumTables; ++t)
+			{
+				Prev[t] = 0.0f;
+				LastChange[t] = Changes[t] = 0;
+			}
+			PrevSign = SignChanges = Steps = 0;
+		}
+
+		void Step(float Difficulty, const FDifficultyParams& Params, float Epsilon)
+		{
+			const float Values[NumTables] = { Difficulty, Params.PlayerVelocity, Params.PlayerDamageMultiplier, Params.PlayerVampirism,
+				Params.EnemyVelocity, Params.EnemyDamage, Params.EnemyNoticeRadius, Params.EnemyCountPercentage };
+			if (Steps)
+			{
+				float Delta = Difficulty - Prev[0];
+				if (FMath::Abs(Delta) > Epsilon)
+				{
+					int Sign = Delta > 0.0f ? 1 : -1;
+					SignChanges += (PrevSign && Sign != PrevSign) ? 1 : 0;
+					PrevSign = Sign;
+				}
+				for (int t = 0; t < NumTables; ++t)
+				{
+					if (FMath::Abs(Values[t] - Prev[t]) > (t ? KINDA_SMALL_NUMBER : Epsilon))
+					{
+						++Changes[t];
+						LastChange[t] = Steps;
+					}
+				}
+			}
+			for (int t = 0; t < NumTables; ++t)
+			{
+				Prev[t] = Values[t];
+			}
+			++Steps;
+		}
+
+		void AddTo(FAccumulator& Accumulator, int Window) const
+		{
+			++Accumulator.Histories;
+			Accumulator.FinalSum += Prev[0];
+			Accumulator.FinalSqSum += Prev[0] * Prev[0];
+			Accumulator.SignChangesSum += SignChanges;
+			for (int t = 0; t < NumTables; ++t)
+			{
+				Accumulator.ChangesSum[t] += Changes[t];
+				Accumulator.Converged[t] += (LastChange[t] <= Steps - Window) ? 1 : 0;
+				++Accumulator.ConvergedAt[t][FMath::Clamp(LastChange[t], 0, Accumulator.ConvergedAt[t].Num() - 1)];
+			}
+		}
+	};
+
+	static const FDifficultyParams& GetBucketParams(const TArray<FDifficultyParams>& BucketParams, int Index)
+	{
+		static const FDifficultyParams Defaults;
+		return BucketParams.IsValidIndex(Index) ? BucketParams[Index] : Defaults;
+	}
+
+	// Synthetic player: a fixed skill in [0.2, 1], wins with a logistic probability of skill against difficulty,
+	// and dies with more chasing enemies and a longer run the more skilled it is
+	static void SimulateHistory(int HistoryIndex, const FSettings& Settings, const FAdaptiveDifficultyModel& Model, const TArray<FDifficultyParams>& BucketParams, FAccumulator& Accumulator)
+	{
+		FRandomStream Stream(int32(HashCombine(GetTypeHash(Settings.Seed), GetTypeHash(HistoryIndex))));
+		float Skill = Stream.FRandRange(0.2f, 1.0f);
+		FRunAggregates Aggregates;
+		FTrajectory Trajectory;
+		for (int Run = 0; Run < Settings.Runs; ++Run)
+		{
+			float Difficulty = Model.Evaluate(Aggregates);
+			Trajectory.Step(Difficulty, GetBucketParams(BucketParams, Model.OutputTable.GetIndex(Difficulty)), Settings.Epsilon);
+
+			FLevelData Data = FLevelData();
+			Data.LevelIndex = -1;
+			Data.DifficultyParameter = Difficulty;
+			Data.PlayerWon = Stream.FRand() < 1.0f / (1.0f + FMath::Exp(-Settings.Steepness * (Skill - Difficulty)));
+			if (!Data.PlayerWon)
+			{
+				Data.OnDeathEnemyChasing = FMath::RoundToInt(Stream.FRand() * (5.0f + 20.0f * Skill));
+				Data.PlayTime = (60.0f + 600.0f * Skill) * Stream.FRandRange(0.5f, 1.5f);
+			}
+			Accumulator.Wins += Data.PlayerWon ? 1 : 0;
+			Aggregates.Add(Data, Settings.RollingStatsWeight);
+		}
+		Trajectory.AddTo(Accumulator, Settings.Window);
+	}
+
+	static int GetPercentile(const TArray<int64>& Histogram, int64 Total, float Percentile)
+	{
+		int64 Target = int64(FMath::CeilToDouble(double(Total) * Percentile));
+		int64 Sum = 0;
+		for (int i = 0; i < Histogram.Num(); ++i)
+		{
+			Sum += Histogram[i];
+			if (Sum >= Target)
+			{
+				return i;
+			}
+		}
+		return Histogram.Num() - 1;
+	}
+
+	static void Report(const FAccumulator& Result, const FSettings& Settings, const FString& CsvPath)
+	{
+		double Count = FMath::Max<double>(Result.Histories, 1.0);
+		double Mean = Result.FinalSum / Count;
+		double Variance = FMath::Max(Result.FinalSqSum / Count - Mean * Mean, 0.0);
+		UE_LOG(LogHypercube, Display, TEXT("Histories: %lld, runs per history: %d, win rate: %.3f"), Result.Histories, Settings.Runs, double(Result.Wins) / (Count * FMath::Max(Settings.Runs, 1)));
+		UE_LOG(LogHypercube, Display, TEXT("Final difficulty: mean %.3f, stddev %.3f, direction changes per history %.2f"), Mean, FMath::Sqrt(Variance), Result.SignChangesSum / Count);
+
+		FString Csv("Table,ConvergedPercent,MeanChanges,LastChangeP50,LastChangeP90\n");
+		for (int t = 0; t < NumTables; ++t)
+		{
+			float Converged = 100.0f * float(double(Result.Converged[t]) / Count);
+			float MeanChanges = float(Result.ChangesSum[t] / Count);
+			int P50 = GetPercentile(Result.ConvergedAt[t], Result.Histories, 0.5f);
+			int P90 = GetPercentile(Result.ConvergedAt[t], Result.Histories, 0.9f);
+			UE_LOG(LogHypercube, Display, TEXT("%-28s converged %6.2f%%, changes %6.2f, last change p50 %3d p90 %3d"), TableNames[t], Converged, MeanChanges, P50, P90);
+			Csv += FString::Printf(TEXT("%s,%f,%f,%d,%d\n"), TableNames[t], Converged, MeanChanges, P50, P90);
+		}
+		if (!CsvPath.IsEmpty())
+		{
+			FFileHelper::SaveStringToFile(Csv, *CsvPath);
+		}
+	}
+}
+
+UBase_DifficultySimCommandlet::UBase_DifficultySimCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UBase_DifficultySimCommandlet::Main(const FString& Params)
+{
+	using namespace DifficultySim;
+
+	UClass* ControllerClass = ABase_LevelController::StaticClass();
+	FString ControllerPath;
+	if (FParse::Value(*Params, TEXT("Controller="), ControllerPath))
+	{
+		ControllerClass = LoadClass<ABase_LevelController>(nullptr, *ControllerPath);
+		if (!ControllerClass)
+		{
+			UE_LOG(LogHypercube, Error, TEXT("Difficulty simulator: can not load level controller class %s"), *ControllerPath);
+			return 1;
+		}
+	}
+	const ABase_LevelController* Controller = GetDefault<ABase_LevelController>(ControllerClass);
+
+	FSettings Settings = { 1000000, 30, 0, 8.0f, 0.01f, 5, Controller->RollingStatsWeight };
+	FParse::Value(*Params, TEXT("Histories="), Settings.Histories);
+	FParse::Value(*Params, TEXT("Runs="), Settings.Runs);
+	FParse::Value(*Params, TEXT("Seed="), Settings.Seed);
+	FParse::Value(*Params, TEXT("Steepness="), Settings.Steepness);
+	FParse::Value(*Params, TEXT("Epsilon="), Settings.Epsilon);
+	FParse::Value(*Params, TEXT("Window="), Settings.Window);
+	Settings.Histories = FMath::Max(Settings.Histories, 0);
+	Settings.Runs = FMath::Max(Settings.Runs, 1);
+	FString CsvPath;
+	FParse::Value(*Params, TEXT("Csv="), CsvPath);
+
+	const FAdaptiveDifficultyModel Model = Controller->BuildDifficultyModel();
+	if (!Model.OutputTable.IsValid())
+	{
+		return 1;
+	}
+	TArray<FDifficultyParams> BucketParams;
+	for (int i = 0; i < Controller->DifficultyParameterBounds.Num(); ++i)
+	{
+		BucketParams.Add(Controller->ResolveDifficultyParams(Model.OutputTable, i));
+	}
+
+	FString SlotName;
+	if (FParse::Value(*Params, TEXT("Slot="), SlotName))
+	{
+		UBase_RunDataSave* LoadedData = Cast<UBase_RunDataSave>(UGameplayStatics::LoadGameFromSlot(SlotName, 0));
+		if (!LoadedData)
+		{
+			UE_LOG(LogHypercube, Error, TEXT("Difficulty simulator: no run data in slot %s"), *SlotName);
+			return 1;
+		}
+		// recorded history: replay the same outcomes through the current tables
+		FRunAggregates Aggregates;
+		FTrajectory Trajectory;
+		FAccumulator Result;
+		Result.Init(FMath::Max(LoadedData->LevelDataArr.Num(), 1));
+		double RecordedDeltaSum = 0.0;
+		for (const FLevelData& Data : LoadedData->LevelDataArr)
+		{
+			float Difficulty = Model.Evaluate(Aggregates);
+			RecordedDeltaSum += FMath::Abs(Difficulty - Data.DifficultyParameter);
+			Trajectory.Step(Difficulty, GetBucketParams(BucketParams, Model.OutputTable.GetIndex(Difficulty)), Settings.Epsilon);
+			Result.Wins += Data.PlayerWon ? 1 : 0;
+			Aggregates.Add(Data, Settings.RollingStatsWeight);
+		}
+		Trajectory.AddTo(Result, Settings.Window);
+		Settings.Runs = LoadedData->LevelDataArr.Num();
+		UE_LOG(LogHypercube, Display, TEXT("Recorded history %s: mean difference to recorded difficulty %.3f"), *SlotName, RecordedDeltaSum / FMath::Max(Settings.Runs, 1));
+		Report(Result, Settings, CsvPath);
+		return 0;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const int BatchSize = 4096;
+	const int NumBatches = FMath::DivideAndRoundUp(Settings.Histories, BatchSize);
+	TArray<FAccumulator> Accumulators;
+	Accumulators.SetNum(NumBatches);
+	ParallelFor(NumBatches, [&](int32 Batch)
+	{
+		FAccumulator& Accumulator = Accumulators[Batch];
+		Accumulator.Init(Settings.Runs);
+		const int End = FMath::Min((Batch + 1) * BatchSize, Settings.Histories);
+		for (int HistoryIndex = Batch * BatchSize; HistoryIndex < End; ++HistoryIndex)
+		{
+			SimulateHistory(HistoryIndex, Settings, Model, BucketParams, Accumulator);
+		}
+	});
+
+	FAccumulator Result;
+	Result.Init(Settings.Runs);
+	for (const FAccumulator& Accumulator : Accumulators)
+	{
+		Result.Merge(Accumulator);
+	}
+	UE_LOG(LogHypercube, Display, TEXT("Simulated %d histories in %.2f s"), Settings.Histories, FPlatformTime::Seconds() - StartTime);
+	Report(Result, Settings, CsvPath);
+	return 0;
+}
@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Base_DifficultySimCommandlet.generated.h"
+
+// Replays synthetic or recorded run histories through the adaptive difficulty tables without a world
+// and reports convergence and oscillation statistics for every parameter table.
+//
+// UE4Editor-Cmd Hypercube.uproject -run=Base_DifficultySim
+//     [-Controller=/Game/LevelController/LevelController.LevelController_C] [-Histories=1000000] [-Runs=30]
+//     [-Seed=0] [-Steepness=8] [-Epsilon=0.01] [-Window=5] [-Slot=RunDataSaveSlot] [-Csv=Saved/DifficultySim.csv]
+UCLASS()
+class UBase_DifficultySimCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UBase_DifficultySimCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
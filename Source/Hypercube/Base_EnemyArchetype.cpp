@@ -0,0 +1,24 @@
+#include "Base_EnemyArchetype.h"
+
+const FPrimaryAssetType UBase_EnemyArchetype::AssetType = TEXT("EnemyArchetype");
+
+UBase_EnemyArchetype::UBase_EnemyArchetype()
+{
+	JumpTime = 2.0f;
+
+	AggroRadius = 800.0f;
+	AggroTime = 0.5f;
+
+	SimpleAttack = { 25.0f, 0.7f, 0.3f, 0.2f, 7.5f, 150.0f, 75.0f, 35.0f };
+
+	UnstuckPlayerSightUpdate = 0.2f;
+	UnstuckAroundPlayerRadius = 1000.0f;
+	MaxAttempsToUnstuck = 10;
+
+	Debug_DamageIndicatorTime = 3.0f;
+}
+
+FPrimaryAssetId UBase_EnemyArchetype::GetPrimaryAssetId() const
+{
+	return FPrimaryAssetId(AssetType, GetFName());
+}
@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Base_EnemyArchetype.generated.h"
+
+USTRUCT(BlueprintType)
+struct FAttackStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Damage;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float OpenerTime;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float AttackTime;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float AfterAttackTime;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float AttackRotationMultiplier;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float AttackMoveForwardSpeed;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float AttackLength;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float AttackWidth;
+};
+
+// Tuning shared by every enemy of a type, referenced by the enemy class instead of copied into each instance.
+// Nothing here changes at runtime; what difficulty and debuffs scale lives in the enemy's FEnemyOverrides.
+// An enemy without an archetype uses the class defaults below.
+UCLASS(BlueprintType)
+class HYPERCUBE_API UBase_EnemyArchetype : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	UBase_EnemyArchetype();
+
+	static const FPrimaryAssetType AssetType;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Stats | Jump")
+	float JumpTime;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Stats | Aggro")
+	float AggroRadius;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Stats | Aggro")
+	float AggroTime;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Stats | Attack")
+	FAttackStats SimpleAttack;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Stats | Unstuck")
+	float UnstuckPlayerSightUpdate;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Stats | Unstuck")
+	float UnstuckAroundPlayerRadius;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Stats | Unstuck")
+	int MaxAttempsToUnstuck;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Debug")
+	float Debug_DamageIndicatorTime;
+
+	virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+};
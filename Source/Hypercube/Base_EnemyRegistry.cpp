@@ -0,0 +1,212 @@
+#include "Base_EnemyRegistry.h"
+#include "Base_NPC_SimpleChase.h"
+
+FEnemyHandle::FEnemyHandle()
+{
+	Invalidate();
+}
+
+bool FEnemyHandle::IsSet() const
+{
+	return Slot != INDEX_NONE;
+}
+
+void FEnemyHandle::Invalidate()
+{
+	Slot = INDEX_NONE;
+	Generation = 0;
+}
+
+FEnemyRegistry::FEnemyRegistry()
+{
+	ChasingCount = 0;
+	AttackingCount = 0;
+	TickingCount = 0;
+}
+
+FEnemyHandle FEnemyRegistry::Add(class ABase_NPC_SimpleChase* Enemy)
+{
+	int32 Slot;
+	if (FreeSlots.Num())
+	{
+		Slot = FreeSlots.Pop(false);
+	}
+	else
+	{
+		Slot = SlotToDense.Add(INDEX_NONE);
+		SlotGeneration.Add(1);
+	}
+	SlotToDense[Slot] = Enemies.Add(Enemy);
+	DenseToSlot.Add(Slot);
+	HotData.Add({ Enemy->GetActorLocation(), Enemy->Health, EEnemyPhase::None, false, false, false });
+
+	FEnemyHandle Handle;
+	Handle.Slot = Slot;
+	Handle.Generation = SlotGeneration[Slot];
+	return Handle;
+}
+
+bool FEnemyRegistry::Remove(const FEnemyHandle& Handle)
+{
+	int Dense = GetDenseIndex(Handle);
+	if (Dense == INDEX_NONE)
+	{
+		return false;
+	}
+	ChasingCount -= HotData[Dense].bChasing ? 1 : 0;
+	AttackingCount -= HotData[Dense].bAttacking ? 1 : 0;
+	TickingCount -= HotData[Dense].bTicking ? 1 : 0;
+
+	int Last = Enemies.Num() - 1;
+	if (Dense != Last)
+	{
+		SlotToDense[DenseToSlot[Last]] = Dense;
+	}
+	HotData.RemoveAtSwap(Dense, 1, false);
+	Enemies.RemoveAtSwap(Dense, 1, false);
+	DenseToSlot.RemoveAtSwap(Dense, 1, false);
+
+	SlotToDense[Handle.Slot] = INDEX_NONE;
+	++SlotGeneration[Handle.Slot];
+	FreeSlots.Add(Handle.Slot);
+	return true;
+}
+
+void FEnemyRegistry::Reset()
+{
+	HotData.Reset();
+	Enemies.Reset();
+	DenseToSlot.Reset();
+	for (int Slot = 0; Slot < SlotToDense.Num(); ++Slot)
+	{
+		if (SlotToDense[Slot] != INDEX_NONE)
+		{
+			SlotToDense[Slot] = INDEX_NONE;
+			++SlotGeneration[Slot];
+			FreeSlots.Add(Slot);
+		}
+	}
+	ChasingCount = 0;
+	AttackingCount = 0;
+	TickingCount = 0;
+}
+
+int FEnemyRegistry::GetDenseIndex(const FEnemyHandle& Handle) const
+{
+	if (!SlotToDense.IsValidIndex(Handle.Slot) || SlotGeneration[Handle.Slot] != Handle.Generation)
+	{
+		return INDEX_NONE;
+	}
+	return SlotToDense[Handle.Slot];
+}
+
+bool FEnemyRegistry::IsValid(const FEnemyHandle& Handle) const
+{
+	return GetDenseIndex(Handle) != INDEX_NONE;
+}
+
+class ABase_NPC_SimpleChase* FEnemyRegistry::Get(const FEnemyHandle& Handle) const
+{
+	int Dense = GetDenseIndex(Handle);
+	return Dense != INDEX_NONE ? Enemies[Dense] : nullptr;
+}
+
+const FEnemyHotData* FEnemyRegistry::GetHotData(const FEnemyHandle& Handle) const
+{
+	int Dense = GetDenseIndex(Handle);
+	return Dense != INDEX_NONE ? &HotData[Dense] : nullptr;
+}
+
+void FEnemyRegistry::SetPhase(const FEnemyHandle& Handle, EEnemyPhase Phase)
+{
+	int Dense = GetDenseIndex(Handle);
+	if (Dense != INDEX_NONE)
+	{
+		HotData[Dense].Phase = Phase;
+	}
+}
+
+void FEnemyRegistry::SetHealth(const FEnemyHandle& Handle, float Health)
+{
+	int Dense = GetDenseIndex(Handle);
+	if (Dense != INDEX_NONE)
+	{
+		HotData[Dense].Health = Health;
+	}
+}
+
+bool FEnemyRegistry::SetChasing(const FEnemyHandle& Handle, bool bChasing)
+{
+	int Dense = GetDenseIndex(Handle);
+	if (Dense == INDEX_NONE || HotData[Dense].bChasing == bChasing)
+	{
+		return false;
+	}
+	HotData[Dense].bChasing = bChasing;
+	ChasingCount += bChasing ? 1 : -1;
+	return true;
+}
+
+bool FEnemyRegistry::IsChasing(const FEnemyHandle& Handle) const
+{
+	int Dense = GetDenseIndex(Handle);
+	return Dense != INDEX_NONE && HotData[Dense].bChasing;
+}
+
+void FEnemyRegistry::SetAttacking(const FEnemyHandle& Handle, bool bAttacking)
+{
+	int Dense = GetDenseIndex(Handle);
+	if (Dense != INDEX_NONE && HotData[Dense].bAttacking != bAttacking)
+	{
+		HotData[Dense].bAttacking = bAttacking;
+		AttackingCount += bAttacking ? 1 : -1;
+	}
+}
+
+void FEnemyRegistry::SetTicking(const FEnemyHandle& Handle, bool bTicking)
+{
+	int Dense = GetDenseIndex(Handle);
+	if (Dense != INDEX_NONE && HotData[Dense].bTicking != bTicking)
+	{
+		HotData[Dense].bTicking = bTicking;
+		TickingCount += bTicking ? 1 : -1;
+	}
+}
+
+void FEnemyRegistry::RefreshPositions()
+{
+	for (int i = 0; i < Enemies.Num(); ++i)
+	{
+		HotData[i].Position = Enemies[i]->GetActorLocation();
+	}
+}
+
+int FEnemyRegistry::Num() const
+{
+	return Enemies.Num();
+}
+
+int FEnemyRegistry::GetChasingCount() const
+{
+	return ChasingCount;
+}
+
+int FEnemyRegistry::GetAttackingCount() const
+{
+	return AttackingCount;
+}
+
+int FEnemyRegistry::GetTickingCount() const
+{
+	return TickingCount;
+}
+
+const TArray<FEnemyHotData>& FEnemyRegistry::GetAllHotData() const
+{
+	return HotData;
+}
+
+const TArray<class ABase_NPC_SimpleChase*>& FEnemyRegistry::GetAllEnemies() const
+{
+	return Enemies;
+}
@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EEnemyPhase : uint8;
+
+struct FEnemyHandle
+{
+	int32 Slot;
+	uint32 Generation;
+
+	FEnemyHandle();
+
+	bool IsSet() const;
+	void Invalidate();
+};
+
+// Per-enemy data that systems iterate every frame, stored contiguously in registry order
+struct FEnemyHotData
+{
+	FVector Position;
+	float Health;
+	EEnemyPhase Phase;
+	bool bChasing;
+	bool bAttacking;
+	bool bTicking;
+};
+
+// Dense enemy storage shared by the level controller, the player and any manager.
+// Handles are slot indices checked by generation, so a stale handle never hits a reused slot;
+// removal swaps the last enemy into the hole and keeps both arrays packed.
+// Enemy pointers are not reference counted: an enemy is removed on death or in its EndPlay, so it is never stored past its lifetime.
+class HYPERCUBE_API FEnemyRegistry
+{
+public:
+
+	FEnemyRegistry();
+
+	FEnemyHandle Add(class ABase_NPC_SimpleChase* Enemy);
+	bool Remove(const FEnemyHandle& Handle); // returns false for stale handles
+	void Reset();
+
+	bool IsValid(const FEnemyHandle& Handle) const;
+	class ABase_NPC_SimpleChase* Get(const FEnemyHandle& Handle) const;
+	const FEnemyHotData* GetHotData(const FEnemyHandle& Handle) const;
+
+	void SetPhase(const FEnemyHandle& Handle, EEnemyPhase Phase);
+	void SetHealth(const FEnemyHandle& Handle, float Health);
+	bool SetChasing(const FEnemyHandle& Handle, bool bChasing); // returns true when the flag changed
+	bool IsChasing(const FEnemyHandle& Handle) const;
+	void SetAttacking(const FEnemyHandle& Handle, bool bAttacking);
+	void SetTicking(const FEnemyHandle& Handle, bool bTicking);
+
+	void RefreshPositions();
+
+	int Num() const;
+	int GetChasingCount() const;
+	int GetAttackingCount() const;
+	int GetTickingCount() const;
+
+	const TArray<FEnemyHotData>& GetAllHotData() const;
+	const TArray<class ABase_NPC_SimpleChase*>& GetAllEnemies() const;
+
+protected:
+
+	TArray<FEnemyHotData> HotData;
+	TArray<class ABase_NPC_SimpleChase*> Enemies;
+	TArray<int32> DenseToSlot;
+
+	TArray<int32> SlotToDense; // INDEX_NONE for free slots
+	TArray<uint32> SlotGeneration;
+	TArray<int32> FreeSlots;
+
+	int ChasingCount;
+	int AttackingCount;
+	int TickingCount;
+
+	int GetDenseIndex(const FEnemyHandle& Handle) const; // returns INDEX_NONE for stale handles
+};
@@ -1,5 +1,6 @@
 #include "Base_EnemySpawnPoint.h"
 #include "Base_NPC_SimpleChase.h"
+#include "Base_LevelSubsystem.h"
 #include "Components/CapsuleComponent.h"
 
 
@@ -27,3 +28,21 @@ class ABase_NPC_SimpleChase* ABase_EnemySpawnPoint::SpawnEnemy() const
 	}
 	return nullptr;
 }
+
+void ABase_EnemySpawnPoint::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+	if (UBase_LevelSubsystem* LevelSubsystem = UBase_LevelSubsystem::Get(this))
+	{
+		LevelSubsystem->RegisterSpawnPoint(this);
+	}
+}
+
+void ABase_EnemySpawnPoint::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UBase_LevelSubsystem* LevelSubsystem = UBase_LevelSubsystem::Get(this))
+	{
+		LevelSubsystem->UnregisterSpawnPoint(this);
+	}
+	Super::EndPlay(EndPlayReason);
+}
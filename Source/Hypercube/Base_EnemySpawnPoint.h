@@ -24,4 +24,9 @@ public:
 	UFUNCTION(BlueprintCallable)
 	class ABase_NPC_SimpleChase* SpawnEnemy() const;
 
+protected:
+
+	virtual void PostInitializeComponents() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 };
@@ -0,0 +1,106 @@
+#include "Base_EnemySpawnSet.h"
+#include "Base_EnemySpawnPoint.h"
+#include "Base_NPC_SimpleChase.h"
+#include "Base_LevelSubsystem.h"
+#include "Engine/Level.h"
+#include "Hypercube.h"
+
+ABase_EnemySpawnSet::ABase_EnemySpawnSet()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+#if WITH_EDITORONLY_DATA
+	bDeleteSpawnPointsAfterBake = false;
+#endif
+}
+
+void ABase_EnemySpawnSet::AppendRecords(TArray<FEnemySpawnRecord>& OutRecords, TArray<UClass*>& OutEnemyClasses) const
+{
+	TArray<int, TInlineAllocator<16>> Remap;
+	for (const TSubclassOf<ABase_NPC_SimpleChase>& EnemyClass : EnemyClasses)
+	{
+		Remap.Add(OutEnemyClasses.AddUnique(EnemyClass.Get()));
+	}
+	OutRecords.Reserve(OutRecords.Num() + Records.Num());
+	for (const FEnemySpawnRecord& Record : Records)
+	{
+		if (!Remap.IsValidIndex(Record.ClassIndex) || !OutEnemyClasses[Remap[Record.ClassIndex]])
+		{
+			continue;
+		}
+		FEnemySpawnRecord& Added = OutRecords.Add_GetRef(Record);
+		Added.ClassIndex = uint8(Remap[Record.ClassIndex]);
+	}
+}
+
+void ABase_EnemySpawnSet::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+	if (UBase_LevelSubsystem* LevelSubsystem = UBase_LevelSubsystem::Get(this))
+	{
+		LevelSubsystem->RegisterSpawnSet(this);
+	}
+}
+
+void ABase_EnemySpawnSet::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UBase_LevelSubsystem* LevelSubsystem = UBase_LevelSubsystem::Get(this))
+	{
+		LevelSubsystem->UnregisterSpawnSet(this);
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+#if WITH_EDITOR
+void ABase_EnemySpawnSet::BakeFromSpawnPoints()
+{
+	ULevel* Level = GetLevel();
+	if (!Level)
+	{
+		return;
+	}
+	Modify();
+	EnemyClasses.Reset();
+	Records.Reset();
+	BakedSpawnPoints.Reset();
+
+	TArray<ABase_EnemySpawnPoint*> Baked;
+	for (AActor* Actor : Level->Actors)
+	{
+		ABase_EnemySpawnPoint* SpawnPoint = Cast<ABase_EnemySpawnPoint>(Actor);
+		if (!SpawnPoint || !SpawnPoint->EnemyClass || !SpawnPoint->EnemyClass->IsChildOf(ABase_NPC_SimpleChase::StaticClass()))
+		{
+			continue;
+		}
+		int ClassIndex = EnemyClasses.AddUnique(SpawnPoint->EnemyClass);
+		if (ClassIndex > MAX_uint8)
+		{
+			UE_LOG(LogHypercube, Error, TEXT("Too many enemy classes in %s, skipping %s"), *GetName(), *SpawnPoint->GetName());
+			EnemyClasses.Pop();
+			continue;
+		}
+		const FRotator Rotation = SpawnPoint->GetActorRotation();
+		if (!FMath::IsNearlyZero(Rotation.Pitch) || !FMath::IsNearlyZero(Rotation.Roll))
+		{
+			UE_LOG(LogHypercube, Warning, TEXT("%s: %s is pitched or rolled, only its yaw is baked"), *GetName(), *SpawnPoint->GetName());
+		}
+		FVector Location = SpawnPoint->GetActorLocation();
+		Location.Z += SpawnPoint->EnemySpawnHeight;
+		Records.Add({ Location, Rotation.Yaw, uint8(ClassIndex) });
+		Baked.Add(SpawnPoint);
+	}
+	UE_LOG(LogHypercube, Display, TEXT("%s: baked %d spawn points, %d enemy classes"), *GetName(), Records.Num(), EnemyClasses.Num());
+
+	if (bDeleteSpawnPointsAfterBake)
+	{
+		for (ABase_EnemySpawnPoint* SpawnPoint : Baked)
+		{
+			GetWorld()->EditorDestroyActor(SpawnPoint, true);
+		}
+	}
+	else
+	{
+		BakedSpawnPoints = Baked;
+	}
+}
+#endif
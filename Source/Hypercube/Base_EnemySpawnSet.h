@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Base_EnemySpawnSet.generated.h"
+
+USTRUCT(BlueprintType)
+struct FEnemySpawnRecord
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FVector Location; // spawn height already applied
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Yaw; // enemies stand upright, so pitch and roll of the spawn point are not kept
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	uint8 ClassIndex; // index into the owning set's EnemyClasses
+};
+
+// All enemy spawn locations of a level in one actor, baked from ABase_EnemySpawnPoint actors in the editor
+UCLASS()
+class HYPERCUBE_API ABase_EnemySpawnSet : public AActor
+{
+	GENERATED_BODY()
+
+public:
+
+	ABase_EnemySpawnSet();
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = EnemyParameters)
+	TArray<TSubclassOf<class ABase_NPC_SimpleChase>> EnemyClasses;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = EnemyParameters)
+	TArray<FEnemySpawnRecord> Records;
+
+	// spawn points already in Records, skipped by the level controller when they are still in the level
+	UPROPERTY(VisibleAnywhere, Category = Bake)
+	TArray<class ABase_EnemySpawnPoint*> BakedSpawnPoints;
+
+	// appends the records with class indices remapped into OutEnemyClasses
+	void AppendRecords(TArray<FEnemySpawnRecord>& OutRecords, TArray<UClass*>& OutEnemyClasses) const;
+
+#if WITH_EDITORONLY_DATA
+	UPROPERTY(EditAnywhere, Category = Bake)
+	bool bDeleteSpawnPointsAfterBake;
+#endif
+
+#if WITH_EDITOR
+	// replaces Records with the spawn point actors of this level; only the yaw of their rotation is kept
+	UFUNCTION(CallInEditor, Category = Bake)
+	void BakeFromSpawnPoints();
+#endif
+
+protected:
+
+	virtual void PostInitializeComponents() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+};
@@ -0,0 +1,101 @@
+#include "Base_GameplayDebugDraw.h"
+
+#if HYPERCUBE_DEBUG_DRAW
+
+#include "Base_EnemyRegistry.h"
+#include "Base_NPC_SimpleChase.h"
+#include "Base_LevelSubsystem.h"
+#include "HypercubeCharacter.h"
+#include "Components/BoxComponent.h"
+#include "DrawDebugHelpers.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+	TAutoConsoleVariable<int32> CVarDebugDraw(
+		TEXT("hypercube.DebugDraw"),
+		0,
+		TEXT("1 draws attack volumes and damage indicators of all enemies and the player, 0 only of actors with bDebug"));
+
+	const FVector DamageMarkerOffset(0.0f, 0.0f, 100.0f);
+	const float DamageMarkerRadius = 20.0f;
+	const float LineThickness = 2.0f;
+}
+
+bool FGameplayDebugDraw::IsEnabledFor(bool bDebug)
+{
+	return bDebug || CVarDebugDraw.GetValueOnGameThread() > 0;
+}
+
+void FGameplayDebugDraw::NoteDamage(const class AActor* Actor, bool bDebug, float Duration)
+{
+	if (!IsEnabledFor(bDebug))
+	{
+		return;
+	}
+	if (UBase_LevelSubsystem* LevelSubsystem = UBase_LevelSubsystem::Get(Actor))
+	{
+		LevelSubsystem->GetDebugDraw().AddDamageMarker(Actor, Actor->GetWorld()->GetTimeSeconds() + Duration);
+	}
+}
+
+// a new hit on the same actor extends its marker
+void FGameplayDebugDraw::AddDamageMarker(const class AActor* Actor, float EndTime)
+{
+	for (FDamageMarker& Marker : DamageMarkers)
+	{
+		if (Marker.Actor == Actor)
+		{
+			Marker.EndTime = EndTime;
+			return;
+		}
+	}
+	DamageMarkers.Add({ Actor, EndTime });
+}
+
+void FGameplayDebugDraw::Reset()
+{
+	DamageMarkers.Empty();
+}
+
+void FGameplayDebugDraw::DrawAttackVolume(class UWorld* World, const class UBoxComponent* Box, bool bHitting)
+{
+	DrawDebugBox(World, Box->GetComponentLocation(), Box->GetScaledBoxExtent(), Box->GetComponentQuat(),
+		bHitting ? FColor::Red : FColor::Yellow, false, -1.0f, 0, LineThickness);
+}
+
+// only attacking enemies have a volume to draw, so the registry's attacking flag skips the rest without touching the actors
+void FGameplayDebugDraw::Draw(class UWorld* World, const class FEnemyRegistry& Registry, const class AHypercubeCharacter* Player)
+{
+	if (Registry.GetAttackingCount())
+	{
+		const TArray<FEnemyHotData>& HotData = Registry.GetAllHotData();
+		const TArray<ABase_NPC_SimpleChase*>& Enemies = Registry.GetAllEnemies();
+		for (int32 i = 0; i < HotData.Num(); ++i)
+		{
+			const ABase_NPC_SimpleChase* Enemy = Enemies[i];
+			if (!HotData[i].bAttacking || !IsValid(Enemy) || !IsEnabledFor(Enemy->bDebug) || Enemy->GetAttackPhase() == EAttackPhase::NotAttacking)
+			{
+				continue;
+			}
+			DrawAttackVolume(World, Enemy->GetAttackCollision(), Enemy->GetAttackPhase() == EAttackPhase::Attacking);
+		}
+	}
+	if (Player && Player->AttackPhase != EPlayerAttackPhase::None && IsEnabledFor(Player->bDebug))
+	{
+		DrawAttackVolume(World, Player->GetAttackCollision(), Player->AttackPhase == EPlayerAttackPhase::Attacking);
+	}
+
+	const float Now = World->GetTimeSeconds();
+	DamageMarkers.RemoveAllSwap([Now](const FDamageMarker& Marker)
+	{
+		return !Marker.Actor.IsValid() || Marker.EndTime <= Now;
+	});
+	for (const FDamageMarker& Marker : DamageMarkers)
+	{
+		DrawDebugSphere(World, Marker.Actor->GetActorLocation() + DamageMarkerOffset, DamageMarkerRadius, 8, FColor::Red, false, -1.0f, 0, LineThickness);
+	}
+}
+
+#endif
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#define HYPERCUBE_DEBUG_DRAW !UE_BUILD_SHIPPING
+
+#if HYPERCUBE_DEBUG_DRAW
+
+// Attack volumes and damage indicators of every enemy and the player, drawn by the level subsystem in one pass per frame
+// as single-frame debug lines, instead of debug components on each actor. Actors with bDebug are drawn; hypercube.DebugDraw 1
+// draws all of them. Attack volumes are read from the attack phase while drawing, damage only leaves a marker with an end time.
+// Everything here, HYPERCUBE_DEBUG_DAMAGE included, is compiled out of Shipping.
+class HYPERCUBE_API FGameplayDebugDraw
+{
+public:
+
+	static bool IsEnabledFor(bool bDebug);
+
+	// shows the damage indicator above Actor for Duration seconds of game time
+	static void NoteDamage(const class AActor* Actor, bool bDebug, float Duration);
+
+	void AddDamageMarker(const class AActor* Actor, float EndTime);
+	void Reset();
+
+	// called once per frame by the level subsystem
+	void Draw(class UWorld* World, const class FEnemyRegistry& Registry, const class AHypercubeCharacter* Player);
+
+protected:
+
+	struct FDamageMarker
+	{
+		TWeakObjectPtr<const class AActor> Actor;
+		float EndTime;
+	};
+
+	TArray<FDamageMarker> DamageMarkers;
+
+	static void DrawAttackVolume(class UWorld* World, const class UBoxComponent* Box, bool bHitting);
+};
+
+#define HYPERCUBE_DEBUG_DAMAGE(Actor, bDebug, Duration) FGameplayDebugDraw::NoteDamage(Actor, bDebug, Duration)
+
+#else
+
+#define HYPERCUBE_DEBUG_DAMAGE(Actor, bDebug, Duration)
+
+#endif
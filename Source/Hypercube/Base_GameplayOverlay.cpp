@@ -0,0 +1,178 @@
+#include "Base_GameplayOverlay.h"
+#include "Base_EnemyRegistry.h"
+#include "Base_NPC_SimpleChase.h"
+#include "HypercubeCharacter.h"
+#include "Debug/DebugDrawService.h"
+#include "Engine/Canvas.h"
+#include "Engine/Engine.h"
+
+FGameplayOverlay::FGameplayOverlay()
+{
+	Reset();
+	TimerCursor = 0;
+	TimerSum = 0;
+	TimerCount = 0;
+}
+
+FGameplayOverlay::~FGameplayOverlay()
+{
+	Show(false);
+}
+
+bool FGameplayOverlay::IsShown() const
+{
+	return DrawHandle.IsValid();
+}
+
+void FGameplayOverlay::Show(bool bShow)
+{
+	if (bShow == IsShown())
+	{
+		return;
+	}
+	if (bShow)
+	{
+		Reset();
+		DrawHandle = UDebugDrawService::Register(TEXT("Game"), FDebugDrawDelegate::CreateRaw(this, &FGameplayOverlay::Draw));
+	}
+	else
+	{
+		UDebugDrawService::Unregister(DrawHandle);
+		DrawHandle.Reset();
+	}
+	FGameplayFrameCounters::bTimeSystems = bShow;
+}
+
+void FGameplayOverlay::Reset()
+{
+	FMemory::Memzero(Samples);
+	FMemory::Memzero(RowStats);
+	for (FRowCells& Cells : RowCells)
+	{
+		for (int32 Column = 0; Column < 4; ++Column)
+		{
+			Cells.Shown[Column] = MIN_int32;
+			Cells.Text[Column].Reset();
+		}
+	}
+	Frame = 0;
+	SelfMs = 0.0f;
+}
+
+// the extremes only need a rescan when the evicted sample was one of them and the new one doesn't replace it
+void FGameplayOverlay::PushSample(int32 Row, float Value)
+{
+	const int32 Slot = Frame % HistoryFrames;
+	FRowStats& Window = RowStats[Row];
+	if (Frame == 0)
+	{
+		Samples[Row][Slot] = Value;
+		Window.Sum = Value;
+		Window.Min = Value;
+		Window.Max = Value;
+		return;
+	}
+	const bool bEvicting = Frame >= HistoryFrames;
+	const float Old = Samples[Row][Slot];
+	Samples[Row][Slot] = Value;
+	Window.Sum += bEvicting ? double(Value) - double(Old) : double(Value);
+	if (bEvicting && ((Old == Window.Min && Value > Old) || (Old == Window.Max && Value < Old)))
+	{
+		Window.Min = Value;
+		Window.Max = Value;
+		for (int32 i = 0; i < HistoryFrames; ++i)
+		{
+			Window.Min = FMath::Min(Window.Min, Samples[Row][i]);
+			Window.Max = FMath::Max(Window.Max, Samples[Row][i]);
+		}
+		return;
+	}
+	Window.Min = FMath::Min(Window.Min, Value);
+	Window.Max = FMath::Max(Window.Max, Value);
+}
+
+void FGameplayOverlay::EndFrame(const class FEnemyRegistry& Registry, const class AHypercubeCharacter* Player)
+{
+	const uint64 Start = FPlatformTime::Cycles64();
+
+	// pending timers, not timers set per frame; summed over a full pass of TimerSliceFrames frames and published
+	// when the cursor wraps
+	const TArray<ABase_NPC_SimpleChase*>& Enemies = Registry.GetAllEnemies();
+	const int32 SliceSize = FMath::DivideAndRoundUp(Enemies.Num(), TimerSliceFrames);
+	const int32 SliceEnd = FMath::Min(TimerCursor + SliceSize, Enemies.Num());
+	for (; TimerCursor < SliceEnd; ++TimerCursor)
+	{
+		TimerSum += Enemies[TimerCursor]->CountActiveTimers();
+	}
+	if (TimerCursor >= Enemies.Num())
+	{
+		TimerCount = TimerSum + (Player ? Player->CountActiveTimers() : 0);
+		TimerSum = 0;
+		TimerCursor = 0;
+	}
+
+	PushSample(Alive, float(Registry.Num()));
+	PushSample(Chasing, float(Registry.GetChasingCount()));
+	PushSample(Attacking, float(Registry.GetAttackingCount()));
+	PushSample(Ticking, float(Registry.GetTickingCount()));
+	PushSample(Timers, float(TimerCount));
+	PushSample(Overlaps, float(FGameplayFrameCounters::OverlapQueries));
+	for (int32 System = 0; System < int(EGameplaySystem::Count); ++System)
+	{
+		PushSample(SystemsBegin + System, float(FPlatformTime::ToMilliseconds64(FGameplayFrameCounters::SystemCycles[System])));
+	}
+	// the previous EndFrame and Draw; this EndFrame is timed whole and shows up with the next sample
+	PushSample(Self, SelfMs);
+	++Frame;
+	SelfMs = float(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - Start));
+}
+
+const TCHAR* FGameplayOverlay::GetRowLabel(int32 Row)
+{
+	static const TCHAR* Labels[RowCount] = {
+		TEXT("Enemies alive"), TEXT("Chasing"), TEXT("Attacking"), TEXT("Ticking"), TEXT("Active timers"), TEXT("Overlap queries"),
+		TEXT("Enemies ms"), TEXT("Player ms"), TEXT("Audio ms"), TEXT("Spawning ms"), TEXT("Save kickoff ms"), TEXT("Difficulty ms"), TEXT("Scoreboard ms"),
+		TEXT("Overlay ms") };
+	return Labels[Row];
+}
+
+void FGameplayOverlay::Draw(class UCanvas* Canvas, class APlayerController* PlayerController)
+{
+	const uint64 Start = FPlatformTime::Cycles64();
+	UFont* Font = GEngine->GetTinyFont();
+	const float LineHeight = 12.0f;
+	const float Columns[] = { 20.0f, 140.0f, 200.0f, 260.0f, 320.0f };
+	float Y = 60.0f;
+
+	Canvas->SetDrawColor(FColor::White);
+	const TCHAR* Header[] = { TEXT("Gameplay"), TEXT("now"), TEXT("min"), TEXT("avg"), TEXT("max") };
+	for (int32 Column = 0; Column < 5; ++Column)
+	{
+		Canvas->DrawText(Font, Header[Column], Columns[Column], Y);
+	}
+
+	const int32 Count = FMath::Min(Frame, HistoryFrames);
+	const int32 Last = (Frame + HistoryFrames - 1) % HistoryFrames;
+	for (int32 Row = 0; Row < RowCount && Count; ++Row)
+	{
+		const FRowStats& Window = RowStats[Row];
+		const float Values[] = { Samples[Row][Last], Window.Min, float(Window.Sum / Count), Window.Max };
+		const bool bMilliseconds = Row >= SystemsBegin;
+		const float Scale = bMilliseconds ? 1000.0f : 1.0f;
+		FRowCells& Cells = RowCells[Row];
+		Y += LineHeight;
+		Canvas->SetDrawColor(Row == Self && Values[3] > 0.1f ? FColor::Red : FColor::White);
+		Canvas->DrawText(Font, GetRowLabel(Row), Columns[0], Y);
+		for (int32 Column = 0; Column < 4; ++Column)
+		{
+			const int32 Shown = FMath::RoundToInt(Values[Column] * Scale);
+			if (Shown != Cells.Shown[Column])
+			{
+				Cells.Shown[Column] = Shown;
+				Cells.Text[Column] = bMilliseconds ? FString::Printf(TEXT("%.3f"), Shown / Scale) : FString::Printf(TEXT("%d"), Shown);
+			}
+			Canvas->DrawText(Font, Cells.Text[Column], Columns[Column + 1], Y);
+		}
+	}
+	SelfMs += float(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - Start));
+}
@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HypercubeStats.h"
+
+// Performance overlay for playtests, toggled with Hypercube.Overlay and drawn in one debug draw pass on the game canvas.
+// Rows keep the last HistoryFrames samples; min, average and max are updated as samples are pushed and the window is only
+// rescanned when an evicted sample was the extreme. Draw re-formats a cell only when its shown value changed. Enemy counts
+// come from the registry's running totals and the active timers row counts the timers pending on a slice of enemies per
+// frame, so the cost stays flat with the enemy count; the overlay's own time, EndFrame and Draw, is the last row.
+class HYPERCUBE_API FGameplayOverlay
+{
+public:
+
+	FGameplayOverlay();
+	~FGameplayOverlay();
+
+	bool IsShown() const;
+	void Show(bool bShow);
+
+	// called once per frame by the level subsystem before the frame counters are reset
+	void EndFrame(const class FEnemyRegistry& Registry, const class AHypercubeCharacter* Player);
+
+protected:
+
+	static const int32 HistoryFrames = 120;
+	static const int32 TimerSliceFrames = 30;
+
+	enum ERow
+	{
+		Alive,
+		Chasing,
+		Attacking,
+		Ticking,
+		Timers,
+		Overlaps,
+		SystemsBegin,
+		Self = SystemsBegin + int(EGameplaySystem::Count),
+		RowCount
+	};
+
+	struct FRowStats
+	{
+		double Sum;
+		float Min;
+		float Max;
+	};
+
+	// what a row's cells show, Shown is the value in display units and the text is only rebuilt when it changes
+	struct FRowCells
+	{
+		int32 Shown[4];
+		FString Text[4];
+	};
+
+	float Samples[RowCount][HistoryFrames];
+	FRowStats RowStats[RowCount];
+	FRowCells RowCells[RowCount];
+	int32 Frame;
+
+	int32 TimerCursor;
+	int32 TimerSum;
+	int32 TimerCount;
+
+	float SelfMs;
+	FDelegateHandle DrawHandle;
+
+	void Reset();
+	void PushSample(int32 Row, float Value);
+	void Draw(class UCanvas* Canvas, class APlayerController* PlayerController);
+	static const TCHAR* GetRowLabel(int32 Row);
+};
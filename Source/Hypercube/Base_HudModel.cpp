@@ -0,0 +1,85 @@
+#include "Base_HudModel.h"
+
+UBase_HudModel::UBase_HudModel()
+{
+	HealthStep = 1.0f;
+	ScoreStep = 1.0f;
+	DamageMultiplierStep = 0.1f;
+
+	for (float& Value : Values)
+	{
+		Value = 0.0f;
+	}
+	for (FHudBarTiming& Bar : Bars)
+	{
+		Bar = { 0.0f, 0.0f, 1.0f, 1.0f };
+	}
+}
+
+float UBase_HudModel::Quantize(EHudValue Value, float NewValue) const
+{
+	float Step = 0.0f;
+	switch (Value)
+	{
+	case EHudValue::Health:
+	case EHudValue::MaxHealth:
+		Step = HealthStep;
+		break;
+	case EHudValue::Score:
+		Step = ScoreStep;
+		break;
+	case EHudValue::DamageMultiplier:
+		Step = DamageMultiplierStep;
+		break;
+	}
+	return Step > 0.0f ? FMath::RoundToFloat(NewValue / Step) * Step : NewValue;
+}
+
+void UBase_HudModel::SetValue(EHudValue Value, float NewValue)
+{
+	if (Value >= EHudValue::Count)
+	{
+		return;
+	}
+	const float Quantized = Quantize(Value, NewValue);
+	if (Values[int(Value)] != Quantized)
+	{
+		Values[int(Value)] = Quantized;
+		ValueChangedDelegate.Broadcast(Value, Quantized);
+	}
+}
+
+void UBase_HudModel::SetBar(EHudBar Bar, float StartTime, float Duration, float From, float To)
+{
+	if (Bar >= EHudBar::Count)
+	{
+		return;
+	}
+	Bars[int(Bar)] = { StartTime, StartTime + FMath::Max(Duration, 0.0f), From, To };
+	BarChangedDelegate.Broadcast(Bar, Bars[int(Bar)]);
+}
+
+float UBase_HudModel::GetValue(EHudValue Value) const
+{
+	return Value < EHudValue::Count ? Values[int(Value)] : 0.0f;
+}
+
+FHudBarTiming UBase_HudModel::GetBar(EHudBar Bar) const
+{
+	return Bar < EHudBar::Count ? Bars[int(Bar)] : FHudBarTiming{ 0.0f, 0.0f, 0.0f, 0.0f };
+}
+
+float UBase_HudModel::GetBarValue(EHudBar Bar, float Time) const
+{
+	return EvaluateBar(GetBar(Bar), Time);
+}
+
+float UBase_HudModel::EvaluateBar(const FHudBarTiming& Timing, float Time)
+{
+	if (Timing.EndTime <= Timing.StartTime)
+	{
+		return Time < Timing.StartTime ? Timing.From : Timing.To;
+	}
+	const float Alpha = FMath::Clamp((Time - Timing.StartTime) / (Timing.EndTime - Timing.StartTime), 0.0f, 1.0f);
+	return FMath::Lerp(Timing.From, Timing.To, Alpha);
+}
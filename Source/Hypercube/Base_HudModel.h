@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Base_HudModel.generated.h"
+
+UENUM(BlueprintType)
+enum class EHudValue : uint8
+{
+	Health UMETA(DisplayName = "Health"),
+	MaxHealth UMETA(DisplayName = "MaxHealth"),
+	Score UMETA(DisplayName = "Score"),
+	DamageMultiplier UMETA(DisplayName = "DamageMultiplier"),
+	Count UMETA(Hidden)
+};
+
+UENUM(BlueprintType)
+enum class EHudBar : uint8
+{
+	Dash UMETA(DisplayName = "Dash"),
+	DamageFX UMETA(DisplayName = "DamageFX"),
+	DamageMultiplier UMETA(DisplayName = "DamageMultiplier"), // the decay between two DamageMultiplier values
+	Count UMETA(Hidden)
+};
+
+// a bar going linearly from From to To between two world times (game time, stops while paused)
+USTRUCT(BlueprintType)
+struct FHudBarTiming
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float StartTime;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float EndTime;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float From;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float To;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnHudValueChanged, EHudValue, Value, float, NewValue);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnHudBarChanged, EHudBar, Bar, const FHudBarTiming&, Timing);
+
+// What the HUD shows, pushed by the character when it changes instead of being polled by UMG bindings every frame.
+// Values are quantized to their step first, so a widget hears about a change only when the number on screen changes.
+// Bars are sent once per transition as start and end times; widgets animate them from the world time.
+UCLASS(BlueprintType, DefaultToInstanced, EditInlineNew)
+class HYPERCUBE_API UBase_HudModel : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UBase_HudModel();
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HUD)
+	float HealthStep;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HUD)
+	float ScoreStep;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HUD)
+	float DamageMultiplierStep;
+
+	UPROPERTY(BlueprintAssignable, Category = EventDispatchers)
+	FOnHudValueChanged ValueChangedDelegate;
+
+	UPROPERTY(BlueprintAssignable, Category = EventDispatchers)
+	FOnHudBarChanged BarChangedDelegate;
+
+	UFUNCTION(BlueprintCallable)
+	void SetValue(EHudValue Value, float NewValue);
+
+	UFUNCTION(BlueprintCallable)
+	void SetBar(EHudBar Bar, float StartTime, float Duration, float From, float To);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	float GetValue(EHudValue Value) const;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	FHudBarTiming GetBar(EHudBar Bar) const;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	float GetBarValue(EHudBar Bar, float Time) const;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	static float EvaluateBar(const FHudBarTiming& Timing, float Time);
+
+protected:
+
+	float Values[int(EHudValue::Count)];
+	FHudBarTiming Bars[int(EHudBar::Count)];
+
+	float Quantize(EHudValue Value, float NewValue) const;
+};
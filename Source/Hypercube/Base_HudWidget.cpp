@@ -0,0 +1,67 @@
+#include "Base_HudWidget.h"
+#include "HypercubeCharacter.h"
+#include "Blueprint/WidgetTree.h"
+#include "Components/InvalidationBox.h"
+#include "Components/RetainerBox.h"
+#include "Hypercube.h"
+
+void UBase_HudWidget::NativeConstruct()
+{
+	Super::NativeConstruct();
+	UWidget* Root = WidgetTree ? WidgetTree->RootWidget : nullptr;
+	if (Root && !Root->IsA<UInvalidationBox>() && !Root->IsA<URetainerBox>())
+	{
+		UE_LOG(LogHypercube, Warning, TEXT("HUD widget %s is not under an invalidation or retainer box, it is repainted every frame"), *GetName());
+	}
+	if (!HudModel)
+	{
+		AHypercubeCharacter* Player = Cast<AHypercubeCharacter>(GetOwningPlayerPawn());
+		SetHudModel(Player ? Player->HudModel : nullptr);
+	}
+}
+
+void UBase_HudWidget::NativeDestruct()
+{
+	SetHudModel(nullptr);
+	Super::NativeDestruct();
+}
+
+void UBase_HudWidget::SetHudModel(UBase_HudModel* NewHudModel)
+{
+	if (HudModel)
+	{
+		HudModel->ValueChangedDelegate.RemoveDynamic(this, &UBase_HudWidget::HandleValueChanged);
+		HudModel->BarChangedDelegate.RemoveDynamic(this, &UBase_HudWidget::HandleBarChanged);
+	}
+	HudModel = NewHudModel;
+	if (!HudModel)
+	{
+		return;
+	}
+	HudModel->ValueChangedDelegate.AddDynamic(this, &UBase_HudWidget::HandleValueChanged);
+	HudModel->BarChangedDelegate.AddDynamic(this, &UBase_HudWidget::HandleBarChanged);
+	for (int Value = 0; Value < int(EHudValue::Count); ++Value)
+	{
+		OnHudValueChanged(EHudValue(Value), HudModel->GetValue(EHudValue(Value)));
+	}
+	for (int Bar = 0; Bar < int(EHudBar::Count); ++Bar)
+	{
+		OnHudBarChanged(EHudBar(Bar), HudModel->GetBar(EHudBar(Bar)));
+	}
+}
+
+float UBase_HudWidget::GetBarValue(EHudBar Bar) const
+{
+	UWorld* World = GetWorld();
+	return HudModel && World ? HudModel->GetBarValue(Bar, World->GetTimeSeconds()) : 0.0f;
+}
+
+void UBase_HudWidget::HandleValueChanged(EHudValue Value, float NewValue)
+{
+	OnHudValueChanged(Value, NewValue);
+}
+
+void UBase_HudWidget::HandleBarChanged(EHudBar Bar, const FHudBarTiming& Timing)
+{
+	OnHudBarChanged(Bar, Timing);
+}
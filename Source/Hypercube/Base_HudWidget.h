@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "Base_HudModel.h"
+#include "Base_HudWidget.generated.h"
+
+// Parent class for HUD widgets. It subscribes to the owning character's HUD model and forwards changes to
+// OnHudValueChanged and OnHudBarChanged, once on construct with the current state and then only when something changes,
+// so the widget tree needs no property bindings. The root should be an invalidation box (or a retainer box for
+// low-rate redraws) so Slate keeps the cached layout between changes; a warning is logged otherwise.
+UCLASS()
+class HYPERCUBE_API UBase_HudWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(BlueprintReadOnly, Category = HUD)
+	UBase_HudModel* HudModel;
+
+	// for widgets created before the player pawn is possessed
+	UFUNCTION(BlueprintCallable)
+	void SetHudModel(UBase_HudModel* NewHudModel);
+
+	// current value of a bar, for the frames it is animating
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	float GetBarValue(EHudBar Bar) const;
+
+protected:
+
+	virtual void NativeConstruct() override;
+	virtual void NativeDestruct() override;
+
+	UFUNCTION(BlueprintImplementableEvent)
+	void OnHudValueChanged(EHudValue Value, float NewValue);
+
+	UFUNCTION(BlueprintImplementableEvent)
+	void OnHudBarChanged(EHudBar Bar, const FHudBarTiming& Timing);
+
+	UFUNCTION()
+	void HandleValueChanged(EHudValue Value, float NewValue);
+
+	UFUNCTION()
+	void HandleBarChanged(EHudBar Bar, const FHudBarTiming& Timing);
+};
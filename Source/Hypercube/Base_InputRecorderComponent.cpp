@@ -0,0 +1,328 @@
+#include "Base_InputRecorderComponent.h"
+#include "Base_LevelController.h"
+#include "Base_NPC_SimpleChase.h"
+#include "HypercubeCharacter.h"
+#include "GameFramework/PlayerController.h"
+#include "Kismet/GameplayStatics.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/CommandLine.h"
+#include "HAL/PlatformTime.h"
+#include "Hypercube.h"
+
+namespace
+{
+	const uint32 ReplayMagic = 0x52494348; // "HCIR"
+	const int32 ReplayVersion = 1;
+	const uint8 ActionsChangedBit = 1 << int(EReplayAxis::Count);
+}
+
+UBase_InputRecorderComponent::UBase_InputRecorderComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	Mode = EMode::None;
+	Header = { 0, 0.5f, 0.0f, -1 };
+	Player = nullptr;
+	CurFrame = PrevFrame = { { 0.0f, 0.0f, 0.0f, 0.0f }, 0 };
+	RecordedFrames = 0;
+	ReplayFrame = 0;
+	bHasExpectedResult = false;
+	ExpectedResult = FLevelData();
+	LastFrameTime = 0.0;
+}
+
+bool UBase_InputRecorderComponent::ParseCommandLine(bool& bOutReplay, FString& OutFile)
+{
+	if (FParse::Value(FCommandLine::Get(), TEXT("HypercubeReplay="), OutFile))
+	{
+		bOutReplay = true;
+		return true;
+	}
+	if (FParse::Value(FCommandLine::Get(), TEXT("HypercubeRecord="), OutFile))
+	{
+		bOutReplay = false;
+		return true;
+	}
+	return false;
+}
+
+FString UBase_InputRecorderComponent::GetReplayPath(const FString& File)
+{
+	return FPaths::IsRelative(File) ? FPaths::ProjectSavedDir() / TEXT("Replays") / File : File;
+}
+
+void UBase_InputRecorderComponent::StartRecording(const FString& File, const FInputRecordingHeader& NewHeader)
+{
+	FilePath = GetReplayPath(File);
+	Header = NewHeader;
+	FrameData.Reset();
+	RecordedFrames = 0;
+	Mode = EMode::Recording;
+	SetComponentTickEnabled(true);
+	UE_LOG(LogHypercube, Warning, TEXT("Recording input to %s"), *FilePath);
+}
+
+bool UBase_InputRecorderComponent::LoadReplay(const FString& File)
+{
+	FilePath = GetReplayPath(File);
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *FilePath))
+	{
+		UE_LOG(LogHypercube, Error, TEXT("Replay %s not found"), *FilePath);
+		return false;
+	}
+	FMemoryReader Reader(Data);
+	uint32 Magic = 0;
+	int32 Version = 0;
+	int32 FrameCount = 0;
+	Reader << Magic << Version;
+	if (Magic != ReplayMagic || Version != ReplayVersion)
+	{
+		UE_LOG(LogHypercube, Error, TEXT("Replay %s has an unknown format"), *FilePath);
+		return false;
+	}
+	Reader << Header.Seed << Header.DifficultyParameter << Header.FixedTimestep << Header.LevelIndex << FrameCount;
+
+	Frames.Reset(FrameCount);
+	FInputFrame Frame = { { 0.0f, 0.0f, 0.0f, 0.0f }, 0 };
+	for (int32 i = 0; i < FrameCount && !Reader.IsError(); ++i)
+	{
+		uint8 Mask = 0;
+		Reader << Mask;
+		for (int Axis = 0; Axis < int(EReplayAxis::Count); ++Axis)
+		{
+			if (Mask & (1 << Axis))
+			{
+				Reader << Frame.Axes[Axis];
+			}
+		}
+		Frame.Actions = 0;
+		if (Mask & ActionsChangedBit)
+		{
+			Reader << Frame.Actions;
+		}
+		Frames.Add(Frame);
+	}
+
+	uint8 bResult = 0;
+	Reader << bResult;
+	bHasExpectedResult = bResult != 0;
+	if (bHasExpectedResult)
+	{
+		uint8 bWon = 0;
+		Reader << bWon << ExpectedResult.Score << ExpectedResult.EnemiesPercentageKilled << ExpectedResult.TotalEnemies;
+		ExpectedResult.PlayerWon = bWon != 0;
+	}
+	if (Reader.IsError())
+	{
+		UE_LOG(LogHypercube, Error, TEXT("Replay %s is truncated"), *FilePath);
+		return false;
+	}
+
+	ReplayFrame = 0;
+	LastFrameTime = 0.0;
+	TimingsCsv = TEXT("Frame,FrameMs,None,Noticing,Chasing\n");
+	Mode = EMode::Replaying;
+	SetComponentTickEnabled(true);
+	UE_LOG(LogHypercube, Warning, TEXT("Replaying %s: %d frames, seed %d, difficulty %f"), *FilePath, Frames.Num(), Header.Seed, Header.DifficultyParameter);
+	return true;
+}
+
+const FInputRecordingHeader& UBase_InputRecorderComponent::GetHeader() const
+{
+	return Header;
+}
+
+bool UBase_InputRecorderComponent::IsRecording() const
+{
+	return Mode == EMode::Recording;
+}
+
+bool UBase_InputRecorderComponent::IsReplaying() const
+{
+	return Mode == EMode::Replaying;
+}
+
+void UBase_InputRecorderComponent::SetPlayer(class AHypercubeCharacter* NewPlayer)
+{
+	Player = NewPlayer;
+	APlayerController* PlayerController = Cast<APlayerController>(Player->GetController());
+	PlayerController = PlayerController ? PlayerController : UGameplayStatics::GetPlayerController(this, 0);
+	if (Mode == EMode::Recording)
+	{
+		// input handlers run during the player controller tick, the frame is stored after it
+		Player->SetInputRecorder(this);
+		if (PlayerController)
+		{
+			PrimaryComponentTick.AddPrerequisite(PlayerController, PlayerController->PrimaryActorTick);
+		}
+	}
+	else if (Mode == EMode::Replaying)
+	{
+		// recorded input is fed before the player controller applies rotation and the movement component consumes it
+		if (PlayerController)
+		{
+			Player->DisableInput(PlayerController);
+			PlayerController->PrimaryActorTick.AddPrerequisite(GetOwner(), PrimaryComponentTick);
+		}
+	}
+}
+
+void UBase_InputRecorderComponent::RecordAxis(EReplayAxis Axis, float Value)
+{
+	if (Mode == EMode::Recording)
+	{
+		CurFrame.Axes[int(Axis)] = Value;
+	}
+}
+
+void UBase_InputRecorderComponent::RecordAction(EReplayAction Action)
+{
+	if (Mode == EMode::Recording)
+	{
+		CurFrame.Actions |= uint8(Action);
+	}
+}
+
+void UBase_InputRecorderComponent::EncodeFrame()
+{
+	uint8 Mask = CurFrame.Actions ? ActionsChangedBit : 0;
+	for (int Axis = 0; Axis < int(EReplayAxis::Count); ++Axis)
+	{
+		if (CurFrame.Axes[Axis] != PrevFrame.Axes[Axis])
+		{
+			Mask |= 1 << Axis;
+		}
+	}
+	FMemoryWriter Writer(FrameData);
+	Writer.Seek(FrameData.Num());
+	Writer << Mask;
+	for (int Axis = 0; Axis < int(EReplayAxis::Count); ++Axis)
+	{
+		if (Mask & (1 << Axis))
+		{
+			Writer << CurFrame.Axes[Axis];
+		}
+	}
+	if (Mask & ActionsChangedBit)
+	{
+		Writer << CurFrame.Actions;
+	}
+	++RecordedFrames;
+	PrevFrame = CurFrame;
+	CurFrame.Actions = 0;
+}
+
+void UBase_InputRecorderComponent::ApplyFrame(const FInputFrame& Frame)
+{
+	if (Player)
+	{
+		Player->ApplyReplayInput(Frame);
+	}
+}
+
+void UBase_InputRecorderComponent::AppendTimings(float DeltaTime)
+{
+	int PhaseCounts[3] = { 0, 0, 0 };
+	ABase_LevelController* LevelController = Cast<ABase_LevelController>(GetOwner());
+	if (LevelController)
+	{
+		for (const FEnemyHotData& Enemy : LevelController->GetEnemyRegistry().GetAllHotData())
+		{
+			++PhaseCounts[FMath::Min(int(Enemy.Phase), 2)];
+		}
+	}
+	double Now = FPlatformTime::Seconds();
+	double FrameMs = LastFrameTime > 0.0 ? (Now - LastFrameTime) * 1000.0 : DeltaTime * 1000.0;
+	LastFrameTime = Now;
+	TimingsCsv += FString::Printf(TEXT("%d,%.3f,%d,%d,%d\n"), ReplayFrame, FrameMs, PhaseCounts[0], PhaseCounts[1], PhaseCounts[2]);
+}
+
+void UBase_InputRecorderComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	if (Mode == EMode::Recording)
+	{
+		EncodeFrame();
+	}
+	else if (Mode == EMode::Replaying)
+	{
+		AppendTimings(DeltaTime);
+		if (Frames.IsValidIndex(ReplayFrame))
+		{
+			ApplyFrame(Frames[ReplayFrame]);
+		}
+		else if (ReplayFrame == Frames.Num())
+		{
+			UE_LOG(LogHypercube, Warning, TEXT("Replay ran out of input at frame %d"), ReplayFrame);
+		}
+		++ReplayFrame;
+	}
+}
+
+bool UBase_InputRecorderComponent::VerifyResult(const FLevelData& Result) const
+{
+	return Result.PlayerWon == ExpectedResult.PlayerWon
+		&& Result.TotalEnemies == ExpectedResult.TotalEnemies
+		&& FMath::IsNearlyEqual(Result.Score, ExpectedResult.Score, 0.01f)
+		&& FMath::IsNearlyEqual(Result.EnemiesPercentageKilled, ExpectedResult.EnemiesPercentageKilled, 0.0001f);
+}
+
+void UBase_InputRecorderComponent::Finish(const FLevelData* Result)
+{
+	if (Mode == EMode::Recording)
+	{
+		TArray<uint8> Data;
+		FMemoryWriter Writer(Data);
+		uint32 Magic = ReplayMagic;
+		int32 Version = ReplayVersion;
+		Writer << Magic << Version;
+		Writer << Header.Seed << Header.DifficultyParameter << Header.FixedTimestep << Header.LevelIndex << RecordedFrames;
+		Writer.Serialize(FrameData.GetData(), FrameData.Num());
+		uint8 bResult = Result ? 1 : 0;
+		Writer << bResult;
+		if (Result)
+		{
+			FLevelData Copy = *Result;
+			uint8 bWon = Copy.PlayerWon ? 1 : 0;
+			Writer << bWon << Copy.Score << Copy.EnemiesPercentageKilled << Copy.TotalEnemies;
+		}
+		FFileHelper::SaveArrayToFile(Data, *FilePath);
+		UE_LOG(LogHypercube, Warning, TEXT("Recorded %d frames (%d bytes) to %s"), RecordedFrames, Data.Num(), *FilePath);
+	}
+	else if (Mode == EMode::Replaying)
+	{
+		FFileHelper::SaveStringToFile(TimingsCsv, *(FilePath + TEXT(".csv")));
+		if (Result)
+		{
+			FLevelData Copy = *Result;
+			Copy.Log();
+			if (!bHasExpectedResult)
+			{
+				UE_LOG(LogHypercube, Warning, TEXT("Recording has no result to compare with"));
+			}
+			else if (VerifyResult(Copy))
+			{
+				UE_LOG(LogHypercube, Warning, TEXT("Replay matches the recording, frame %d of %d"), ReplayFrame, Frames.Num());
+			}
+			else
+			{
+				UE_LOG(LogHypercube, Error, TEXT("Replay diverged: frame %d of %d, score %f expected %f, won %d expected %d"),
+					ReplayFrame, Frames.Num(), Copy.Score, ExpectedResult.Score, int(Copy.PlayerWon), int(ExpectedResult.PlayerWon));
+			}
+		}
+		if (FParse::Param(FCommandLine::Get(), TEXT("HypercubeReplayExit")))
+		{
+			FPlatformMisc::RequestExit(false);
+		}
+	}
+	else
+	{
+		return;
+	}
+	Mode = EMode::Finished;
+	SetComponentTickEnabled(false);
+}
@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Base_RunDataSave.h"
+#include "Base_InputRecorderComponent.generated.h"
+
+enum class EReplayAxis : uint8
+{
+	MoveForward,
+	MoveRight,
+	Turn,
+	LookUp,
+	Count
+};
+
+// bit flags, several actions can happen in one frame
+enum class EReplayAction : uint8
+{
+	JumpPressed = 1,
+	JumpReleased = 2,
+	Dash = 4,
+	Attack = 8
+};
+
+struct FInputFrame
+{
+	float Axes[int(EReplayAxis::Count)];
+	uint8 Actions;
+};
+
+struct FInputRecordingHeader
+{
+	int32 Seed;
+	float DifficultyParameter;
+	float FixedTimestep;
+	int32 LevelIndex;
+};
+
+// Records the player's input of a deterministic run and plays it back as a benchmark.
+// Started by the level controller with -HypercubeRecord=<file> or -HypercubeReplay=<file> (add -nullrhi for headless replays,
+// -HypercubeReplayExit to quit when the run ends). Files go to Saved/Replays; frames only store the axes that changed.
+// A replay writes per-frame timings and enemy phase counts to <file>.csv and checks the final FLevelData against the recording.
+UCLASS()
+class HYPERCUBE_API UBase_InputRecorderComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UBase_InputRecorderComponent();
+
+	// returns true if the command line asks for a recording or a replay
+	static bool ParseCommandLine(bool& bOutReplay, FString& OutFile);
+
+	void StartRecording(const FString& File, const FInputRecordingHeader& Header);
+	bool LoadReplay(const FString& File); // returns false if the file is missing or broken
+
+	const FInputRecordingHeader& GetHeader() const;
+	bool IsRecording() const;
+	bool IsReplaying() const;
+
+	void SetPlayer(class AHypercubeCharacter* Player);
+
+	void RecordAxis(EReplayAxis Axis, float Value);
+	void RecordAction(EReplayAction Action);
+
+	// Result is null when the level ended without a result, e.g. on quit
+	void Finish(const FLevelData* Result);
+
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+
+	enum class EMode : uint8
+	{
+		None,
+		Recording,
+		Replaying,
+		Finished
+	};
+
+	EMode Mode;
+	FString FilePath;
+	FInputRecordingHeader Header;
+	class AHypercubeCharacter* Player;
+
+	// recording
+	FInputFrame CurFrame;
+	FInputFrame PrevFrame;
+	TArray<uint8> FrameData;
+	int32 RecordedFrames;
+
+	// replaying
+	TArray<FInputFrame> Frames;
+	int32 ReplayFrame;
+	bool bHasExpectedResult;
+	FLevelData ExpectedResult;
+	double LastFrameTime;
+	FString TimingsCsv;
+
+	void EncodeFrame();
+	void ApplyFrame(const FInputFrame& Frame);
+	void AppendTimings(float DeltaTime);
+	bool VerifyResult(const FLevelData& Result) const;
+
+	static FString GetReplayPath(const FString& File);
+};
@@ -3,38 +3,66 @@
 #include "HypercubeCharacter.h"
 #include "Base_NPC_SimpleChase.h"
 #include "Base_EnemySpawnPoint.h"
+#include "Base_LevelSubsystem.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Math/UnrealMathUtility.h"
 #include "Components/SphereComponent.h"
 #include "Components/AudioComponent.h"
 #include "Components/SceneComponent.h"
-
-bool FScoreboardData::operator<(const FScoreboardData& Other) const
-{
-	return Score > Other.Score;
-}
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "UObject/StrongObjectPtr.h"
+#include "Base_InputRecorderComponent.h"
+#include "Base_BotComponent.h"
+#include "Base_ScalingBenchmarkComponent.h"
+#include "HypercubeStats.h"
+#include "HypercubeEventLog.h"
+#include "Hypercube.h"
 
 ABase_LevelController::ABase_LevelController()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bCanEverTick = false;
 
 	AfterPlayerDeathTime = 5.0f;
 	FewEnemiesEventPercentage = 0.03f;
 
-	NoticeSoundTurnOffTime = 1.0f;
-	bEnemyCanNoticeSound = true;
+	SpawnSelectionMode = ESpawnSelectionMode::Stratified;
+	SpawnStratumSize = 2000.0f;
+	MaxEnemiesPerStratum = 0;
+	SpawnSeed = 0;
+
+	bDeterministic = false;
+	DeterministicSeed = 1;
+	DeterministicDifficulty = 0.5f;
+	FixedTimestep = 1.0f / 60.0f;
+	bFixedTimestepApplied = false;
+	PreviousFixedDeltaTime = 0.0;
+	RecordingFrameStart = 0.0;
+	InputRecorder = nullptr;
+	Bot = nullptr;
+	ScalingBenchmark = nullptr;
+	BenchmarkEnemyClass = nullptr;
+	RunSeed = 0;
 
-	FootstepSoundTurnOffTime = 0.2f;
+	bEnemyCanNoticeSound = true;
 	bEnemyCanFootstepSound = true;
-
-	DeathSoundTurnOffTime = 1.0f;
 	bEnemyCanDeathSound = true;
+	NoticeSoundTurnOffTime = 1.0f;
+	FootstepSoundTurnOffTime = 0.2f;
+	DeathSoundTurnOffTime = 1.0f;
 
 	LevelNames = { "training", "level_1_upd", "level_2", "level_3" };
 	LevelNamesToShow = { "Tutorial", "Level1", "Level2", "Level3" };
 
 	SaveSlotName = "RunDataSaveSlot";
 	CurLevelData = { false, 0.0f, 0.0f, 0, 1.0f, 1.0f, 0, 0.0f };
+	ScoreboardCapacity = 20;
+	RollingStatsWeight = 0.3f;
+	bLevelDataLoaded = false;
+	bLevelDataLoading = false;
 
 	EnemiesKilled = 0;
 
@@ -75,54 +103,208 @@ ABase_LevelController::ABase_LevelController()
 	MusicComp_High = CreateDefaultSubobject<UAudioComponent>(TEXT("Music High"));
 	MusicComp_High->SetupAttachment(RootComponent);
 
+	AudioBudget = CreateDefaultSubobject<UBase_AudioBudgetComponent>(TEXT("Audio Budget"));
+
 	MusicParameter = TargetMusicParameter = 0.0f;
+	MusicFadeTime = 1.5f;
 	MusicChangeSpeed = 2.0f;
 	MusicRefreshFrequency = 2.0f;
 	MusicVolumeMultiplier = 0.25f;
-	MusicRefreshTimer = 0.0f;
 }
 
+void ABase_LevelController::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+	CompileDifficultyCurves();
+	UpdateDifficultyParams();
+	if (UBase_LevelSubsystem* LevelSubsystem = UBase_LevelSubsystem::Get(this))
+	{
+		LevelSubsystem->RegisterLevelController(this);
+	}
+}
+
+void ABase_LevelController::InitDeterminism()
+{
+	int CommandLineSeed;
+	if (FParse::Value(FCommandLine::Get(), TEXT("HypercubeSeed="), CommandLineSeed))
+	{
+		bDeterministic = true;
+		DeterministicSeed = CommandLineSeed;
+	}
+
+	// a recorded run keeps the player's adaptive difficulty, a replay takes everything from the recording
+	bool bReplay;
+	FString ReplayFile;
+	if (UBase_InputRecorderComponent::ParseCommandLine(bReplay, ReplayFile))
+	{
+		InputRecorder = NewObject<UBase_InputRecorderComponent>(this, TEXT("Input Recorder"));
+		InputRecorder->RegisterComponent();
+		if (!bReplay)
+		{
+			DeterministicSeed = bDeterministic ? DeterministicSeed : FMath::Rand();
+			DeterministicDifficulty = GetDifficultyParameter();
+			bDeterministic = true;
+		}
+		else if (InputRecorder->LoadReplay(ReplayFile))
+		{
+			const FInputRecordingHeader& Header = InputRecorder->GetHeader();
+			DeterministicSeed = Header.Seed;
+			DeterministicDifficulty = Header.DifficultyParameter;
+			FixedTimestep = Header.FixedTimestep;
+			bDeterministic = true;
+			if (Header.LevelIndex != CurLevelIndex)
+			{
+				UE_LOG(LogHypercube, Error, TEXT("Replay was recorded on level %d"), Header.LevelIndex);
+			}
+		}
+		else
+		{
+			InputRecorder->DestroyComponent();
+			InputRecorder = nullptr;
+		}
+	}
+	// bot sessions are never saved into the player's history
+	if (!InputRecorder && UBase_BotComponent::IsRequested())
+	{
+		Bot = NewObject<UBase_BotComponent>(this, TEXT("Bot"));
+		Bot->RegisterComponent();
+		DeterministicSeed = bDeterministic ? DeterministicSeed : FMath::Rand();
+		bDeterministic = true;
+	}
+	if (!InputRecorder && !Bot && UBase_ScalingBenchmarkComponent::IsRequested())
+	{
+		ScalingBenchmark = NewObject<UBase_ScalingBenchmarkComponent>(this, TEXT("Scaling Benchmark"));
+		ScalingBenchmark->RegisterComponent();
+		DeterministicSeed = bDeterministic ? DeterministicSeed : 1;
+		bDeterministic = true;
+	}
+
+	int Seed = bDeterministic ? DeterministicSeed : (SpawnSeed ? SpawnSeed : FMath::Rand());
+	RunSeed = Seed;
+	SpawnStream.Initialize(Seed);
+	UnstuckStream.Initialize(bDeterministic ? int32(HashCombine(uint32(Seed), 1)) : FMath::Rand());
+	UE_LOG(LogHypercube, Warning, TEXT("Seed: %d%s"), Seed, bDeterministic ? TEXT(" (deterministic)") : TEXT(""));
+
+	if (bDeterministic && FixedTimestep > 0.0f && !FApp::UseFixedTimeStep())
+	{
+		PreviousFixedDeltaTime = FApp::GetFixedDeltaTime();
+		FApp::SetUseFixedTimeStep(true);
+		FApp::SetFixedDeltaTime(FixedTimestep);
+		bFixedTimestepApplied = true;
+		UE_LOG(LogHypercube, Warning, TEXT("Fixed timestep: %f"), FixedTimestep);
+		// the engine doesn't wait on a fixed timestep, a human player needs the game at real-time speed
+		if (InputRecorder && !InputRecorder->IsReplaying())
+		{
+			RecordingFrameStart = FPlatformTime::Seconds();
+			RecordingThrottleHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &ABase_LevelController::ThrottleRecording);
+		}
+	}
+
+	if (InputRecorder)
+	{
+		if (!InputRecorder->IsReplaying())
+		{
+			InputRecorder->StartRecording(ReplayFile, { Seed, DeterministicDifficulty, bFixedTimestepApplied ? FixedTimestep : 0.0f, CurLevelIndex });
+		}
+		if (Player)
+		{
+			InputRecorder->SetPlayer(Player);
+		}
+	}
+	if (Bot && Player)
+	{
+		Bot->Start(Player, int32(HashCombine(uint32(RunSeed), 2)));
+	}
+	if (ScalingBenchmark && Player)
+	{
+		ScalingBenchmark->Start(Player);
+	}
+}
+
+void ABase_LevelController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (InputRecorder)
+	{
+		InputRecorder->Finish(nullptr);
+	}
+	FCoreDelegates::OnEndFrame.Remove(RecordingThrottleHandle);
+	RecordingThrottleHandle.Reset();
+	if (bFixedTimestepApplied)
+	{
+		FApp::SetUseFixedTimeStep(false);
+		FApp::SetFixedDeltaTime(PreviousFixedDeltaTime);
+		bFixedTimestepApplied = false;
+	}
+	if (UBase_LevelSubsystem* LevelSubsystem = UBase_LevelSubsystem::Get(this))
+	{
+		LevelSubsystem->UnregisterLevelController(this);
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+// each frame advances game time by FixedTimestep, so it may not end sooner than FixedTimestep of real time after the last;
+// a frame that took longer slows the game down instead of making the replay differ
+void ABase_LevelController::ThrottleRecording()
+{
+	const double Wait = RecordingFrameStart + FixedTimestep - FPlatformTime::Seconds();
+	if (Wait > 0.0)
+	{
+		FPlatformProcess::SleepNoStats(float(Wait));
+	}
+	RecordingFrameStart = FPlatformTime::Seconds();
+}
+
+#if WITH_EDITOR
+void ABase_LevelController::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	CompileDifficultyCurves();
+	UpdateDifficultyParams();
+}
+#endif
+
 void ABase_LevelController::BeginPlay()
 {
-	UE_LOG(LogTemp, Warning, TEXT("%s"), *(GetWorld()->GetMapName()));
+	UE_LOG(LogHypercube, Log, TEXT("%s"), *(GetWorld()->GetMapName()));
 	CurLevelIndex = GetCurMapIndex();
 	if (CurLevelIndex < 0)
 	{
-		UE_LOG(LogTemp, Error, TEXT("Invalid map!"));
+		UE_LOG(LogHypercube, Error, TEXT("Invalid map!"));
 	}
-	LoadLevelData();
-	DifficultyParameter = GetDifficultyParameter();
+	LoadRunSummary();
+	InitDeterminism();
+	DifficultyParameter = bDeterministic ? DeterministicDifficulty : GetDifficultyParameter();
+	UpdateDifficultyParams();
+	FHypercubeEventLog::Record(EHypercubeEvent::LevelBegin, this, float(CurLevelIndex), DifficultyParameter);
 	SpawnEnemies();
-	MusicComp_Explore->SetVolumeMultiplier(((MusicParameter > 0.5f ? 0.0f : 1.0f - MusicParameter * 2.0f) + 0.001f) * MusicVolumeMultiplier);
-	MusicComp_Low->SetVolumeMultiplier(((MusicParameter < 0.5f ? MusicParameter * 2.0f : 1.0f) + 0.001f) * MusicVolumeMultiplier);
-	MusicComp_High->SetVolumeMultiplier(((MusicParameter < 0.5f ? 0.0f : (MusicParameter - 0.5f) * 2.0f) + 0.001f) * MusicVolumeMultiplier);
+	MusicComp_Explore->SetVolumeMultiplier(MusicVolumeMultiplier);
+	MusicComp_Low->SetVolumeMultiplier(MusicVolumeMultiplier);
+	MusicComp_High->SetVolumeMultiplier(MusicVolumeMultiplier);
 	MusicComp_Explore->Play();
 	MusicComp_Low->Play();
 	MusicComp_High->Play();
+	SetMusicParameter(MusicParameter, 0.0f);
 	Super::BeginPlay();
 }
 
-void ABase_LevelController::Tick(float DeltaSeconds)
+void ABase_LevelController::OnEnemyChasingCountChanged(int ChasingCount)
 {
-	MusicRefreshTimer += DeltaSeconds;
-	if (MusicRefreshTimer >= MusicRefreshFrequency)
+	float NewParameter = GetTargetMusicParameter();
+	if (NewParameter != MusicParameter)
 	{
-		MusicRefreshTimer = 0.0f;
-		TargetMusicParameter = GetTargetMusicParameter();
-	}
-	if (MusicParameter != TargetMusicParameter)
-	{
-		MusicParameter = FMath::Lerp(MusicParameter, TargetMusicParameter, MusicChangeSpeed * DeltaSeconds);
-		if (FMath::IsNearlyEqual(MusicParameter, TargetMusicParameter, 0.001f))
-		{
-			MusicParameter = TargetMusicParameter;
-		}
-		MusicComp_Explore->SetVolumeMultiplier(((MusicParameter > 0.5f ? 0.0f : 1.0f - MusicParameter * 2.0f) + 0.001f) * MusicVolumeMultiplier);
-		MusicComp_Low->SetVolumeMultiplier(((MusicParameter < 0.5f ? MusicParameter * 2.0f : 1.0f) + 0.001f) * MusicVolumeMultiplier);
-		MusicComp_High->SetVolumeMultiplier(((MusicParameter < 0.5f ? 0.0f : (MusicParameter - 0.5f) * 2.0f) + 0.001f) * MusicVolumeMultiplier);
+		SetMusicParameter(NewParameter, MusicFadeTime);
 	}
 }
 
+// the fade runs on the active sounds, nothing has to be updated per frame here
+void ABase_LevelController::SetMusicParameter(float NewParameter, float FadeTime)
+{
+	MusicParameter = TargetMusicParameter = NewParameter;
+	MusicComp_Explore->AdjustVolume(FadeTime, (MusicParameter > 0.5f ? 0.0f : 1.0f - MusicParameter * 2.0f) + 0.001f);
+	MusicComp_Low->AdjustVolume(FadeTime, (MusicParameter < 0.5f ? MusicParameter * 2.0f : 1.0f) + 0.001f);
+	MusicComp_High->AdjustVolume(FadeTime, (MusicParameter < 0.5f ? 0.0f : (MusicParameter - 0.5f) * 2.0f) + 0.001f);
+}
+
 int ABase_LevelController::GetCurMapIndex() const
 {
 	const FString CurMapName = GetWorld()->GetMapName();
@@ -139,28 +321,74 @@ int ABase_LevelController::GetCurMapIndex() const
 
 void ABase_LevelController::ReadScoreboardData()
 {
-	if (Scores.Num())
+	Scoreboard.Build(LevelData, ScoreboardCapacity);
+}
+
+FString ABase_LevelController::GetSummarySlotName() const
+{
+	return SaveSlotName + "_Summary";
+}
+
+void ABase_LevelController::EnsureLevelDataLoaded()
+{
+	if (!bLevelDataLoaded)
 	{
-		return;
+		LoadLevelData();
 	}
-	for (int i = 0; i < LevelData.Num(); ++i)
+}
+
+void ABase_LevelController::LoadRunSummary()
+{
+	UBase_RunSummarySave* LoadedSummary = Cast<UBase_RunSummarySave>(UGameplayStatics::LoadGameFromSlot(GetSummarySlotName(), 0));
+	if (LoadedSummary)
 	{
-		if (LevelData[i].Score > 0.0f)
+		RunAggregates = LoadedSummary->Aggregates;
+		Scoreboard.Restore(LoadedSummary->Scoreboard, ScoreboardCapacity);
+		UE_LOG(LogHypercube, Log, TEXT("Total level walkthroughs: %d"), RunAggregates.TotalRuns);
+		if (RunAggregates.TotalRuns)
 		{
-			FScoreboardData Data = { LevelData[i].Score, LevelData[i].DifficultyParameter, LevelData[i].LevelIndex };
-			Scores.Add(Data);
+			RunAggregates.LastRun.Log();
 		}
+		RequestLevelData();
+		return;
+	}
+	// no summary yet: fall back to the full history once and derive the aggregates from it
+	LoadLevelData();
+}
+
+void ABase_LevelController::RequestLevelData()
+{
+	if (bLevelDataLoaded || bLevelDataLoading)
+	{
+		return;
+	}
+	bLevelDataLoading = true;
+	UGameplayStatics::AsyncLoadGameFromSlot(SaveSlotName, 0, FAsyncLoadGameFromSlotDelegate::CreateUObject(this, &ABase_LevelController::OnLevelDataLoaded));
+}
+
+void ABase_LevelController::OnLevelDataLoaded(const FString& SlotName, const int32 UserIndex, class USaveGame* SaveGame)
+{
+	bLevelDataLoading = false;
+	if (!bLevelDataLoaded) // a synchronous load or ClearLevelData got there first
+	{
+		ApplyLevelData(Cast<UBase_RunDataSave>(SaveGame));
 	}
-	Scores.Sort();
 }
 
 void ABase_LevelController::LoadLevelData()
 {
-	UBase_RunDataSave* LoadedData = Cast<UBase_RunDataSave>(UGameplayStatics::LoadGameFromSlot(SaveSlotName, 0));
+	ApplyLevelData(Cast<UBase_RunDataSave>(UGameplayStatics::LoadGameFromSlot(SaveSlotName, 0)));
+}
+
+// the history is the source of truth: a summary that does not cover the same runs (no summary yet, or a crash
+// between the two slot writes) is rebuilt from it
+void ABase_LevelController::ApplyLevelData(class UBase_RunDataSave* LoadedData)
+{
+	bLevelDataLoaded = true;
 	if (LoadedData)
 	{
 		LevelData = LoadedData->LevelDataArr;
-		UE_LOG(LogTemp, Warning, TEXT("Total level walkthroughs: %d"), LevelData.Num());
+		UE_LOG(LogHypercube, Log, TEXT("Total level walkthroughs: %d"), LevelData.Num());
 		if (LevelData.Num())
 		{
 			LevelData.Last().Log();
@@ -168,32 +396,140 @@ void ABase_LevelController::LoadLevelData()
 	}
 	else
 	{
-		UE_LOG(LogTemp, Warning, TEXT("No data to load"));
+		UE_LOG(LogHypercube, Log, TEXT("No data to load"));
+	}
+	if (RunAggregates.TotalRuns != LevelData.Num())
+	{
+		UE_LOG(LogHypercube, Log, TEXT("Run summary covers %d runs, history has %d, rebuilding"), RunAggregates.TotalRuns, LevelData.Num());
+		RunAggregates.Rebuild(LevelData, RollingStatsWeight);
+		ReadScoreboardData();
 	}
 }
 
+const TArray<FLevelData>& ABase_LevelController::GetLevelData()
+{
+	EnsureLevelDataLoaded();
+	return LevelData;
+}
+
 void ABase_LevelController::SpawnEnemies()
 {
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), ABase_EnemySpawnPoint::StaticClass(), SpawnPoints);
-	for (int i = 0; i < SpawnPoints.Num(); ++i)
+	SCOPE_CYCLE_COUNTER(STAT_Hypercube_SpawnEnemies);
+	GAMEPLAY_SYSTEM_SCOPE(Spawning);
+	CollectSpawnRecords();
+	if (ScalingBenchmark)
+	{
+		// the benchmark spawns its own tiers, the records only provide its enemy class
+		UE_LOG(LogHypercube, Log, TEXT("Level spawning disabled for the scaling benchmark"));
+		return;
+	}
+	int WantedCount = FMath::CeilToInt(float(SpawnRecords.Num()) * DifficultyParams.EnemyCountPercentage);
+	WantedCount = WantedCount > SpawnRecords.Num() ? SpawnRecords.Num() : WantedCount;
+
+	TArray<int32> Selected;
+	if (SpawnSelectionMode == ESpawnSelectionMode::Stratified)
 	{
-		SpawnPoints.Swap(i, FMath::RandRange(i, SpawnPoints.Num() - 1));
+		SpawnStrata.Select(WantedCount, SpawnStream, MaxEnemiesPerStratum, Selected);
 	}
-	float EnemyPercentage = GetOutputParameterFrom(DifficultyParameter, DifficultyParameterBounds, EnemyCountPercentageValues);
-	BeginEnemyCount = FMath::CeilToInt(float(SpawnPoints.Num()) * EnemyPercentage);
-	BeginEnemyCount = BeginEnemyCount > SpawnPoints.Num() ? SpawnPoints.Num() : BeginEnemyCount;
+	else
+	{
+		Selected.SetNumUninitialized(SpawnRecords.Num());
+		for (int i = 0; i < Selected.Num(); ++i)
+		{
+			Selected[i] = i;
+		}
+		for (int i = 0; i < WantedCount; ++i)
+		{
+			Selected.Swap(i, SpawnStream.RandRange(i, Selected.Num() - 1));
+		}
+		Selected.SetNum(WantedCount);
+	}
+	BeginEnemyCount = Selected.Num();
 	CurLevelData.TotalEnemies = BeginEnemyCount;
 	FewEnemiesEventCount = FMath::CeilToInt(FewEnemiesEventPercentage * (float)BeginEnemyCount);
-	UE_LOG(LogTemp, Warning, TEXT("Enemies spawned: %d"), BeginEnemyCount);
-	UE_LOG(LogTemp, Warning, TEXT("Few enemies event: %d"), FewEnemiesEventCount);
-	for (int i = 0; i < BeginEnemyCount; ++i)
+	FHypercubeEventLog::Record(EHypercubeEvent::EnemiesSpawned, this, float(BeginEnemyCount), float(WantedCount));
+	UE_LOG(LogHypercube, Log, TEXT("Enemies spawned: %d of %d (%d strata), few enemies event: %d"), BeginEnemyCount, WantedCount, SpawnStrata.NumStrata(), FewEnemiesEventCount);
+	for (int32 Index : Selected)
+	{
+		const FEnemySpawnRecord& Record = SpawnRecords[Index];
+		SpawnEnemyAt(SpawnEnemyClasses[Record.ClassIndex], Record.Location, FRotator(0.0f, Record.Yaw, 0.0f));
+	}
+}
+
+// -HypercubeScalingEnemy=/Game/NPCs/... overrides the class, the first enemy class of the level is the fallback
+TSubclassOf<class ABase_NPC_SimpleChase> ABase_LevelController::GetBenchmarkEnemyClass() const
+{
+	FString ClassPath;
+	if (FParse::Value(FCommandLine::Get(), TEXT("HypercubeScalingEnemy="), ClassPath))
+	{
+		return LoadClass<ABase_NPC_SimpleChase>(nullptr, *ClassPath);
+	}
+	if (BenchmarkEnemyClass)
+	{
+		return BenchmarkEnemyClass;
+	}
+	return SpawnEnemyClasses.Num() ? SpawnEnemyClasses[0] : nullptr;
+}
+
+// baked spawn sets first, then the spawn point actors that no set has baked
+void ABase_LevelController::CollectSpawnRecords()
+{
+	SpawnRecords.Reset();
+	SpawnEnemyClasses.Reset();
+	SpawnStrata.Reset();
+	UBase_LevelSubsystem* LevelSubsystem = UBase_LevelSubsystem::Get(this);
+	if (!LevelSubsystem)
 	{
-		ABase_EnemySpawnPoint* SpawnPoint = Cast<ABase_EnemySpawnPoint>(SpawnPoints[i]);
-		if (SpawnPoint)
+		return;
+	}
+	TSet<const ABase_EnemySpawnPoint*> BakedSpawnPoints;
+	for (const ABase_EnemySpawnSet* SpawnSet : LevelSubsystem->GetSpawnSets())
+	{
+		SpawnSet->AppendRecords(SpawnRecords, SpawnEnemyClasses);
+		for (const ABase_EnemySpawnPoint* SpawnPoint : SpawnSet->BakedSpawnPoints)
+		{
+			BakedSpawnPoints.Add(SpawnPoint);
+		}
+	}
+	for (const ABase_EnemySpawnPoint* SpawnPoint : LevelSubsystem->GetSpawnPoints())
+	{
+		if (BakedSpawnPoints.Contains(SpawnPoint) || !SpawnPoint->EnemyClass || !SpawnPoint->EnemyClass->IsChildOf(ABase_NPC_SimpleChase::StaticClass()))
+		{
+			continue;
+		}
+		int ClassIndex = SpawnEnemyClasses.AddUnique(SpawnPoint->EnemyClass);
+		if (ClassIndex > MAX_uint8)
 		{
-			SpawnEnemy(SpawnPoint);
+			SpawnEnemyClasses.Pop();
+			continue;
 		}
+		FVector Location = SpawnPoint->GetActorLocation();
+		Location.Z += SpawnPoint->EnemySpawnHeight;
+		SpawnRecords.Add({ Location, SpawnPoint->GetActorRotation().Yaw, uint8(ClassIndex) });
 	}
+	SpawnStrata.Build(SpawnRecords, SpawnStratumSize);
+}
+
+class ABase_NPC_SimpleChase* ABase_LevelController::SpawnEnemyAt(TSubclassOf<class ABase_NPC_SimpleChase> EnemyClass, FVector Location, FRotator Rotation)
+{
+	if (!EnemyClass || !EnemyClass->IsChildOf(ABase_NPC_SimpleChase::StaticClass()))
+	{
+		UE_LOG(LogHypercube, Warning, TEXT("Cannot spawn %s as an enemy"), *GetNameSafe(EnemyClass));
+		return nullptr;
+	}
+	ABase_NPC_SimpleChase* Enemy = GetWorld()->SpawnActor<ABase_NPC_SimpleChase>(EnemyClass, Location, Rotation);
+	if (Enemy)
+	{
+		Enemy->SpawnDefaultController();
+		Enemy->LevelController = this;
+		SetEnemyParams(Enemy);
+		AddEnemy(Enemy);
+		if (UBase_LevelSubsystem* LevelSubsystem = UBase_LevelSubsystem::Get(this))
+		{
+			LevelSubsystem->NoteEnemySpawned();
+		}
+	}
+	return Enemy;
 }
 
 void ABase_LevelController::SpawnEnemy(class ABase_EnemySpawnPoint* SpawnPoint)
@@ -203,7 +539,7 @@ void ABase_LevelController::SpawnEnemy(class ABase_EnemySpawnPoint* SpawnPoint)
 	{
 		Enemy->LevelController = this;
 		SetEnemyParams(Enemy);
-		Enemies.Add(Enemy);
+		AddEnemy(Enemy);
 	}
 }
 
@@ -214,27 +550,58 @@ void ABase_LevelController::AddEnemiesKilled()
 
 void ABase_LevelController::AddEnemy(class ABase_NPC_SimpleChase* Enemy)
 {
-	Enemies.Add(Enemy);
+	if (!EnemyRegistry.IsValid(Enemy->RegistryHandle))
+	{
+		Enemy->RegistryHandle = EnemyRegistry.Add(Enemy);
+	}
 }
 
 void ABase_LevelController::RemoveEnemy(class ABase_NPC_SimpleChase* Enemy)
 {
-	if (Enemies.Contains(Enemy))
+	RemoveEnemies(MakeArrayView(&Enemy, 1));
+}
+
+void ABase_LevelController::RemoveEnemies(TArrayView<class ABase_NPC_SimpleChase* const> Enemies)
+{
+	for (ABase_NPC_SimpleChase* Enemy : Enemies)
 	{
-		Enemies.Remove(Enemy);
-		AddEnemiesKilled();
+		if (EnemyRegistry.Remove(Enemy->RegistryHandle))
+		{
+			Enemy->RegistryHandle.Invalidate();
+			AddEnemiesKilled();
+		}
 	}
-	if (Enemies.Num() <= FewEnemiesEventCount)
+	if (EnemyRegistry.Num() <= FewEnemiesEventCount)
 	{
 		FewEnemiesRemainingDelegate.Broadcast();
-		UE_LOG(LogTemp, Warning, TEXT("Few enemies remaining!"));
+		UE_LOG(LogHypercube, Log, TEXT("Few enemies remaining!"));
 	}
-	if (!Enemies.Num())
+	if (!EnemyRegistry.Num())
 	{
 		OnAllEnemiesDead();
 	}
 }
 
+FEnemyRegistry& ABase_LevelController::GetEnemyRegistry()
+{
+	return EnemyRegistry;
+}
+
+FRandomStream& ABase_LevelController::GetSpawnStream()
+{
+	return SpawnStream;
+}
+
+FRandomStream& ABase_LevelController::GetUnstuckStream()
+{
+	return UnstuckStream;
+}
+
+bool ABase_LevelController::IsDeterministic() const
+{
+	return bDeterministic;
+}
+
 void ABase_LevelController::UpdateMaxMultiplicator(float NewMultiplicator)
 {
 	if (NewMultiplicator > CurLevelData.MaxMultiplicator)
@@ -245,14 +612,31 @@ void ABase_LevelController::UpdateMaxMultiplicator(float NewMultiplicator)
 
 void ABase_LevelController::SetPlayerCharacter(class AHypercubeCharacter* PlayerCharacter)
 {
+	if (Player)
+	{
+		Player->EnemyChasingCountChangedDelegate.RemoveAll(this);
+	}
 	Player = PlayerCharacter;
+	Player->EnemyChasingCountChangedDelegate.AddUObject(this, &ABase_LevelController::OnEnemyChasingCountChanged);
+	if (InputRecorder)
+	{
+		InputRecorder->SetPlayer(Player);
+	}
+	if (Bot)
+	{
+		Bot->Start(Player, int32(HashCombine(uint32(RunSeed), 2)));
+	}
+	if (ScalingBenchmark)
+	{
+		ScalingBenchmark->Start(Player);
+	}
 	SetPlayerParams();
 }
 
 void ABase_LevelController::OnPlayerDeath()
 {
 	CurLevelData.PlayerWon = false;
-	TargetMusicParameter = 0.0f;
+	SetMusicParameter(0.0f, MusicFadeTime);
 	SaveLevelData();
 	GetWorld()->GetTimerManager().SetTimer(AfterLevelTimerHandle, this, &ABase_LevelController::AfterPlayerDeath, AfterPlayerDeathTime, false);
 }
@@ -271,26 +655,80 @@ void ABase_LevelController::OnAllEnemiesDead()
 
 void ABase_LevelController::SaveLevelData()
 {
+	SCOPE_CYCLE_COUNTER(STAT_Hypercube_SaveLevelData);
+	GAMEPLAY_SYSTEM_SCOPE(Saving);
 	CurLevelData.Score = Player->Score;
 	CurLevelData.EnemiesPercentageKilled = float(EnemiesKilled) / float(BeginEnemyCount);
-	UpdateMaxMultiplicator(Player->DamageMultiplier);
-	CurLevelData.OnDeathMultiplicator = Player->DamageMultiplier;
+	UpdateMaxMultiplicator(Player->GetDamageMultiplier());
+	CurLevelData.OnDeathMultiplicator = Player->GetDamageMultiplier();
 	CurLevelData.OnDeathEnemyChasing = Player->GetEnemyChasingCount();
 	CurLevelData.PlayTime = UGameplayStatics::GetRealTimeSeconds(GetWorld());
 	CurLevelData.DifficultyParameter = DifficultyParameter;
 	CurLevelData.LevelIndex = CurLevelIndex;
+	// a recorded session is a real game and is saved; replays, bots, benchmarks and seeded runs must not feed
+	// the adaptive difficulty history
+	const bool bRecordedSession = InputRecorder && InputRecorder->IsRecording();
+	if (InputRecorder)
+	{
+		InputRecorder->Finish(&CurLevelData);
+	}
+	if (bDeterministic && !bRecordedSession)
+	{
+		CurLevelData.Log();
+		if (Bot)
+		{
+			Bot->OnLevelFinished(CurLevelData);
+		}
+		return;
+	}
+	EnsureLevelDataLoaded();
 	LevelData.Add(CurLevelData);
+	RunAggregates.Add(CurLevelData, RollingStatsWeight);
+	if (CurLevelData.Score > 0.0f)
+	{
+		Scoreboard.Add({ CurLevelData.Score, CurLevelData.DifficultyParameter, CurLevelData.LevelIndex });
+	}
 	UBase_RunDataSave* SaveGameInstance = Cast<UBase_RunDataSave>(UGameplayStatics::CreateSaveGameObject(UBase_RunDataSave::StaticClass()));
-	if (SaveGameInstance)
+	UBase_RunSummarySave* SummaryInstance = Cast<UBase_RunSummarySave>(UGameplayStatics::CreateSaveGameObject(UBase_RunSummarySave::StaticClass()));
+	if (!SaveGameInstance || !SummaryInstance)
+	{
+		return;
+	}
+	SaveGameInstance->LevelDataArr = LevelData;
+	SummaryInstance->Aggregates = RunAggregates;
+	SummaryInstance->Scoreboard = Scoreboard.GetEntries();
+	// the file writes run in the background; the summary is written only after the history made it to disk,
+	// and the save objects are held by the callback because the level may be reloaded before it runs
+	TStrongObjectPtr<UBase_RunSummarySave> Summary(SummaryInstance);
+	const FString SummarySlotName = GetSummarySlotName();
+	const double SaveStart = FPlatformTime::Seconds();
+	UGameplayStatics::AsyncSaveGameToSlot(SaveGameInstance, SaveSlotName, 0, FAsyncSaveGameToSlotDelegate::CreateLambda(
+		[Summary, SummarySlotName, SaveStart](const FString& SlotName, const int32 UserIndex, bool bSuccess)
+		{
+			if (!bSuccess)
+			{
+				UE_LOG(LogHypercube, Warning, TEXT("Could not save %s, keeping the previous run summary"), *SlotName);
+				return;
+			}
+			UGameplayStatics::AsyncSaveGameToSlot(Summary.Get(), SummarySlotName, UserIndex, FAsyncSaveGameToSlotDelegate::CreateLambda(
+				[SaveStart](const FString& SummarySlot, const int32 SummaryUser, bool bSummarySaved)
+				{
+					UE_LOG(LogHypercube, Log, TEXT("Run history and %s %s after %.1f ms"), *SummarySlot,
+						bSummarySaved ? TEXT("saved") : TEXT("failed"), (FPlatformTime::Seconds() - SaveStart) * 1000.0);
+				}));
+		}));
+	if (UBase_LevelSubsystem* LevelSubsystem = UBase_LevelSubsystem::Get(this))
 	{
-		SaveGameInstance->LevelDataArr = LevelData;
-		UGameplayStatics::SaveGameToSlot(SaveGameInstance, SaveSlotName, 0);
+		LevelSubsystem->NoteSave();
 	}
 }
 
 void ABase_LevelController::ClearLevelData()
 {
+	bLevelDataLoaded = true;
 	LevelData.Empty();
+	RunAggregates.Reset();
+	Scoreboard.Reset(ScoreboardCapacity);
 }
 
 void ABase_LevelController::ReloadCurrentLevel()
@@ -303,80 +741,138 @@ void ABase_LevelController::LoadNextLevel()
 	UGameplayStatics::OpenLevel(GetWorld(), FName(*LevelNames[(CurLevelIndex + 1) % LevelNames.Num()]));
 }
 
-void ABase_LevelController::SetNoticeSoundTurnOff()
+void ABase_LevelController::RequestEnemySound(EEnemySoundCategory Category, class USoundBase* Sound, FVector Location)
 {
-	bEnemyCanNoticeSound = false;
-	GetWorld()->GetTimerManager().SetTimer(NoticeSoundTurnOffTimerHandle, this, &ABase_LevelController::OnEndNoticeSoundTurnedOff, NoticeSoundTurnOffTime, false);
+	AudioBudget->RequestSound(Category, Sound, Location);
 }
 
-void ABase_LevelController::OnEndNoticeSoundTurnedOff()
+class UBase_AudioBudgetComponent* ABase_LevelController::GetAudioBudget() const
 {
-	bEnemyCanNoticeSound = true;
+	return AudioBudget;
 }
 
-void ABase_LevelController::SetFootstepSoundTurnOff()
+bool& ABase_LevelController::GetLegacySoundFlag(EEnemySoundCategory Category)
 {
-	bEnemyCanFootstepSound = false;
-	GetWorld()->GetTimerManager().SetTimer(FootstepSoundTurnOffTimerHandle, this, &ABase_LevelController::OnEndFootstepSoundTurnedOff, FootstepSoundTurnOffTime, false);
+	switch (Category)
+	{
+	case EEnemySoundCategory::Notice:
+		return bEnemyCanNoticeSound;
+	case EEnemySoundCategory::Footstep:
+		return bEnemyCanFootstepSound;
+	default:
+		return bEnemyCanDeathSound;
+	}
 }
 
-void ABase_LevelController::OnEndFootstepSoundTurnedOff()
+float ABase_LevelController::GetLegacySoundTurnOffTime(EEnemySoundCategory Category) const
 {
-	bEnemyCanFootstepSound = true;
+	switch (Category)
+	{
+	case EEnemySoundCategory::Notice:
+		return NoticeSoundTurnOffTime;
+	case EEnemySoundCategory::Footstep:
+		return FootstepSoundTurnOffTime;
+	default:
+		return DeathSoundTurnOffTime;
+	}
 }
 
-void ABase_LevelController::SetDeathSoundTurnOff()
+void ABase_LevelController::TurnOffLegacySound(EEnemySoundCategory Category)
 {
-	bEnemyCanDeathSound = false;
-	GetWorld()->GetTimerManager().SetTimer(DeathSoundTurnOffTimerHandle, this, &ABase_LevelController::OnEndDeathSoundTurnedOff, DeathSoundTurnOffTime, false);
+	AudioBudget->NoteExternalPlay(Category);
+	const float Interval = FMath::Max(GetLegacySoundTurnOffTime(Category), AudioBudget->GetMinInterval(Category));
+	if (Interval <= 0.0f)
+	{
+		return;
+	}
+	GetLegacySoundFlag(Category) = false;
+	GetWorld()->GetTimerManager().SetTimer(LegacySoundTimerHandles[int(Category)],
+		FTimerDelegate::CreateUObject(this, &ABase_LevelController::OnEndLegacySoundTurnOff, Category), Interval, false);
 }
 
-void ABase_LevelController::OnEndDeathSoundTurnedOff()
+void ABase_LevelController::OnEndLegacySoundTurnOff(EEnemySoundCategory Category)
 {
-	bEnemyCanDeathSound = true;
+	GetLegacySoundFlag(Category) = true;
+}
+
+void ABase_LevelController::SetNoticeSoundTurnOff()
+{
+	TurnOffLegacySound(EEnemySoundCategory::Notice);
+}
+
+void ABase_LevelController::SetFootstepSoundTurnOff()
+{
+	TurnOffLegacySound(EEnemySoundCategory::Footstep);
+}
+
+void ABase_LevelController::SetDeathSoundTurnOff()
+{
+	TurnOffLegacySound(EEnemySoundCategory::Death);
 }
 
 float ABase_LevelController::GetDifficultyParameter()
 {
 	if (!FMath::IsNearlyEqual(DeathCountCost + OnDeathEnemyAggroCost + PlayTimeCost, 1.0f))
 	{
-		UE_LOG(LogTemp, Error, TEXT("Sum of input parameter costs must be equal to 1!"));
-	}
-	if (!LevelData.Num())
-	{
-		return 0.5f;
-	}
-	int i = LevelData.Num() - 1;
-	while (i >= 0 && !LevelData[i].PlayerWon)
-	{
-		--i;
+		UE_LOG(LogHypercube, Error, TEXT("Sum of input parameter costs must be equal to 1!"));
 	}
-	int DeathCount = LevelData.Num() - 1 - i;
-	int OnDeathChasing = LevelData.Last().OnDeathEnemyChasing;
-	float PlayTime = LevelData.Last().PlayTime;
-	bool IsWon = LevelData.Last().PlayerWon;
+	float Result = DifficultyModel.Evaluate(RunAggregates);
+	UE_LOG(LogHypercube, Log, TEXT("In: %d, %d, %f"), RunAggregates.DeathStreak, RunAggregates.LastRun.OnDeathEnemyChasing, RunAggregates.LastRun.PlayTime);
+	UE_LOG(LogHypercube, Log, TEXT("Out: %f"), Result);
+	return Result;
+}
+
+void ABase_LevelController::CompileDifficultyCurves()
+{
+	SCOPE_CYCLE_COUNTER(STAT_Hypercube_DifficultyCompile);
+	GAMEPLAY_SYSTEM_SCOPE(Difficulty);
+	DifficultyModel = BuildDifficultyModel();
+}
 
-	float DeathCountParameter = GetDifficultyParameterFrom(DeathCount, DeathCountBounds, DeathCountValues) * DeathCountCost;
-	float OnDeathChasingParameter = (IsWon ? 1.0f : GetDifficultyParameterFrom(OnDeathChasing, OnDeathEnemyAggroBounds, OnDeathEnemyAggroValues)) * OnDeathEnemyAggroCost;
-	float PlayTimeParameter = (IsWon ? 1.0f : GetDifficultyParameterFrom(PlayTime, PlayTimeBounds, PlayTimeValues)) * PlayTimeCost;
+void ABase_LevelController::UpdateDifficultyParams()
+{
+	DifficultyParams = ResolveDifficultyParams(DifficultyModel.OutputTable, DifficultyModel.OutputTable.GetIndex(DifficultyParameter));
+	BuildDifficultyBrief();
+}
 
-	UE_LOG(LogTemp, Warning, TEXT("In: %d, %d, %f"), DeathCount, OnDeathChasing, PlayTime);
-	UE_LOG(LogTemp, Warning, TEXT("Out: %f, %f, %f"), DeathCountParameter, OnDeathChasingParameter, PlayTimeParameter);
-	return DeathCountParameter + OnDeathChasingParameter + PlayTimeParameter;
+FAdaptiveDifficultyModel ABase_LevelController::BuildDifficultyModel() const
+{
+	FAdaptiveDifficultyModel Model;
+	Model.DeathCountCurve.Compile(DeathCountBounds, DeathCountValues);
+	Model.OnDeathEnemyAggroCurve.Compile(OnDeathEnemyAggroBounds, OnDeathEnemyAggroValues);
+	Model.PlayTimeCurve.Compile(PlayTimeBounds, PlayTimeValues);
+	Model.DeathCountCost = DeathCountCost;
+	Model.OnDeathEnemyAggroCost = OnDeathEnemyAggroCost;
+	Model.PlayTimeCost = PlayTimeCost;
+	Model.OutputTable.Compile(DifficultyParameterBounds);
+	return Model;
+}
+
+FDifficultyParams ABase_LevelController::ResolveDifficultyParams(const FDifficultyOutputTable& OutputTable, int Index) const
+{
+	FDifficultyParams Params;
+	const FDifficultyParams Defaults;
+	Params.PlayerVelocity = OutputTable.GetValue(Index, PlayerVelocityValues, Defaults.PlayerVelocity, TEXT("PlayerVelocityValues"));
+	Params.PlayerDamageMultiplier = OutputTable.GetValue(Index, PlayerDamageMultiplerValues, Defaults.PlayerDamageMultiplier, TEXT("PlayerDamageMultiplerValues"));
+	Params.PlayerVampirism = OutputTable.GetValue(Index, PlayerVampirismValues, Defaults.PlayerVampirism, TEXT("PlayerVampirismValues"));
+	Params.EnemyVelocity = OutputTable.GetValue(Index, EnemyVelocityValues, Defaults.EnemyVelocity, TEXT("EnemyVelocityValues"));
+	Params.EnemyDamage = OutputTable.GetValue(Index, EnemyDamageValues, Defaults.EnemyDamage, TEXT("EnemyDamageValues"));
+	Params.EnemyNoticeRadius = OutputTable.GetValue(Index, EnemyNoticeRadiusValues, Defaults.EnemyNoticeRadius, TEXT("EnemyNoticeRadiusValues"));
+	Params.EnemyCountPercentage = OutputTable.GetValue(Index, EnemyCountPercentageValues, Defaults.EnemyCountPercentage, TEXT("EnemyCountPercentageValues"));
+	return Params;
 }
 
 void ABase_LevelController::SetPlayerParams()
 {
-	Player->GetCharacterMovement()->MaxWalkSpeed *= GetOutputParameterFrom(DifficultyParameter, DifficultyParameterBounds, PlayerVelocityValues);
-	Player->DamageMultiplierEnemyCost *= GetOutputParameterFrom(DifficultyParameter, DifficultyParameterBounds, PlayerDamageMultiplerValues);
-	Player->Vampirism = GetOutputParameterFrom(DifficultyParameter, DifficultyParameterBounds, PlayerVampirismValues);
+	Player->GetCharacterMovement()->MaxWalkSpeed *= DifficultyParams.PlayerVelocity;
+	Player->DamageMultiplierEnemyCost *= DifficultyParams.PlayerDamageMultiplier;
+	Player->Vampirism = DifficultyParams.PlayerVampirism;
 }
 
 void ABase_LevelController::SetEnemyParams(class ABase_NPC_SimpleChase* Enemy)
 {
-	Enemy->GetCharacterMovement()->MaxWalkSpeed *= GetOutputParameterFrom(DifficultyParameter, DifficultyParameterBounds, EnemyVelocityValues);
-	Enemy->SimpleAttack.Damage *= GetOutputParameterFrom(DifficultyParameter, DifficultyParameterBounds, EnemyDamageValues);
-	Enemy->GetNoticeCollision()->SetSphereRadius(Enemy->AggroRadius * GetOutputParameterFrom(DifficultyParameter, DifficultyParameterBounds, EnemyNoticeRadiusValues));
+	Enemy->GetCharacterMovement()->MaxWalkSpeed *= DifficultyParams.EnemyVelocity;
+	Enemy->SetDifficultyScale(DifficultyParams.EnemyDamage, DifficultyParams.EnemyNoticeRadius);
 }
 
 float ABase_LevelController::GetTargetMusicParameter()
@@ -397,105 +893,58 @@ float ABase_LevelController::GetTargetMusicParameter()
 	return 1.0f;
 }
 
+FScoreboardView ABase_LevelController::GetScoreboardView(int Num)
+{
+	SCOPE_CYCLE_COUNTER(STAT_Hypercube_Scoreboard);
+	GAMEPLAY_SYSTEM_SCOPE(Scoreboard);
+	return Scoreboard.GetView(Num, LevelNamesToShow);
+}
+
 FString ABase_LevelController::GetScoreboard(int Num)
 {
-	ReadScoreboardData();
-	if (!Scores.Num())
-	{
-		return FString("");
-	}
-	FString Result = "Scoreboard:\n\n      Level        Difficulty    Score\n";
-	Num = Num > Scores.Num() ? Scores.Num() : Num;
-	for (int i = 0; i < Num; ++i)
-	{
-		FScoreboardData Data = Scores[Scores.Num() - 1 - i];
-		Result.AppendInt(i + 1);
-		Result += (i + 1 < 10) ? FString(".  ") : FString(". ");
-		FString LevelName = (Data.LevelIndex >= 0 && Data.LevelIndex < LevelNamesToShow.Num()) ? LevelNamesToShow[Data.LevelIndex] : FString("????");
-		Result += LevelName;
-		for (int j = 0; j < 12 - LevelName.Len(); ++j)
-		{
-			Result.AppendChar(' ');
-		}
-		FString DifficultyString = FloatToFString(Data.DifficultyParameter);
-		Result += DifficultyString;
-		int SpaceCount = DifficultyString.Len() < 3 ? 20 : 13;
-		for (int j = 0; j < SpaceCount; ++j)
-		{
-			Result.AppendChar(' ');
-		}
-		Result.AppendInt(FMath::RoundToInt(Data.Score));
-		Result.AppendChar('\n');
-	}
-	return Result;
+	return Scoreboard.GetView(Num, LevelNamesToShow).Table;
 }
 
 FString ABase_LevelController::GetScoreboardEnumerate(int Num)
 {
-	ReadScoreboardData();
-	int Count = Scores.Num() > Num ? Num : Scores.Num();
-	FString Result("");
-	for (int i = 0; i < Count; ++i)
-	{
-		Result.AppendInt(i + 1);
-		Result.AppendChar('\n');
-	}
-	return Result;
+	return Scoreboard.GetView(Num, LevelNamesToShow).Places;
 }
 
 FString ABase_LevelController::GetScoreboardLevels(int Num)
 {
-	ReadScoreboardData();
-	int Count = Scores.Num() > Num ? Num : Scores.Num();
-	FString Result("Level\n\n");
-	for (int i = 0; i < Count; ++i)
-	{
-		Result += (Scores[i].LevelIndex >= 0 && Scores[i].LevelIndex < LevelNamesToShow.Num()) ? LevelNamesToShow[Scores[i].LevelIndex] : FString("????");
-		Result.AppendChar('\n');
-	}
-	return Result;
+	return Scoreboard.GetView(Num, LevelNamesToShow).Levels;
 }
 
 FString ABase_LevelController::GetScoreboardScores(int Num)
 {
-	ReadScoreboardData();
-	int Count = Scores.Num() > Num ? Num : Scores.Num();
-	FString Result("Score\n\n");
-	for (int i = 0; i < Count; ++i)
-	{
-		Result.AppendInt(FMath::RoundToInt(Scores[i].Score));
-		Result.AppendChar('\n');
-	}
-	return Result;
+	return Scoreboard.GetView(Num, LevelNamesToShow).Scores;
 }
 
 FString ABase_LevelController::GetScoreboardDiffs(int Num)
 {
-	ReadScoreboardData();
-	int Count = Scores.Num() > Num ? Num : Scores.Num();
-	FString Result("Difficulty\n\n");
-	for (int i = 0; i < Count; ++i)
-	{
-		Result += FloatToFString(Scores[i].DifficultyParameter);
-		Result.AppendChar('\n');
-	}
-	return Result;
+	return Scoreboard.GetView(Num, LevelNamesToShow).Diffs;
 }
 
 FString ABase_LevelController::GetDifficultyBrief() const
+{
+	return DifficultyBrief;
+}
+
+// the brief only changes with the difficulty parameter, widgets polling it every frame get the cached text
+void ABase_LevelController::BuildDifficultyBrief()
 {
 	FString Result = "Difficulty parameter: " + FloatToFString(DifficultyParameter);
-	Result += FString("\n\n\nPlayer stats:\n\nSpeed: x") + FloatToFString(GetOutputParameterFrom(DifficultyParameter, DifficultyParameterBounds, PlayerVelocityValues));
-	Result += FString("\nDamage stats growing speed: x") + FloatToFString(GetOutputParameterFrom(DifficultyParameter, DifficultyParameterBounds, PlayerDamageMultiplerValues));
+	Result += FString("\n\n\nPlayer stats:\n\nSpeed: x") + FloatToFString(DifficultyParams.PlayerVelocity);
+	Result += FString("\nDamage stats growing speed: x") + FloatToFString(DifficultyParams.PlayerDamageMultiplier);
 	Result += FString("\nVampirism: ");
-	Result.AppendInt(int(GetOutputParameterFrom(DifficultyParameter, DifficultyParameterBounds, PlayerVampirismValues) * 100.0f));
-	Result += FString("%\n\n\nEnemy stats:\n\nSpeed: x") + FloatToFString(GetOutputParameterFrom(DifficultyParameter, DifficultyParameterBounds, EnemyVelocityValues));
-	Result += FString("\nDamage: x") + FloatToFString(GetOutputParameterFrom(DifficultyParameter, DifficultyParameterBounds, EnemyDamageValues));
-	Result += FString("\nNotice radius: x") + FloatToFString(GetOutputParameterFrom(DifficultyParameter, DifficultyParameterBounds, EnemyNoticeRadiusValues));
+	Result.AppendInt(int(DifficultyParams.PlayerVampirism * 100.0f));
+	Result += FString("%\n\n\nEnemy stats:\n\nSpeed: x") + FloatToFString(DifficultyParams.EnemyVelocity);
+	Result += FString("\nDamage: x") + FloatToFString(DifficultyParams.EnemyDamage);
+	Result += FString("\nNotice radius: x") + FloatToFString(DifficultyParams.EnemyNoticeRadius);
 	Result += FString("\nEnemy Count: ");
-	Result.AppendInt(int(GetOutputParameterFrom(DifficultyParameter, DifficultyParameterBounds, EnemyCountPercentageValues) * 100.0f));
+	Result.AppendInt(int(DifficultyParams.EnemyCountPercentage * 100.0f));
 	Result.AppendChar('%');
-	return Result;
+	DifficultyBrief = MoveTemp(Result);
 }
 
 FString FloatToFString(float Val)
@@ -5,24 +5,21 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Base_RunDataSave.h"
+#include "Base_RunSummarySave.h"
+#include "Base_Scoreboard.h"
+#include "Base_DifficultyCurve.h"
+#include "Base_EnemyRegistry.h"
+#include "Base_AudioBudgetComponent.h"
+#include "Base_EnemySpawnSet.h"
+#include "Base_SpawnStrata.h"
 #include "Containers/SortedMap.h"
 #include "Base_LevelController.generated.h"
 
-USTRUCT(BlueprintType)
-struct FScoreboardData
+UENUM(BlueprintType)
+enum class ESpawnSelectionMode : uint8
 {
-	GENERATED_BODY()
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	float Score;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	float DifficultyParameter;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	int LevelIndex;
-
-	bool operator<(const FScoreboardData& Other) const;
+	Shuffle UMETA(DisplayName = "Shuffle"),
+	Stratified UMETA(DisplayName = "Stratified")
 };
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnAllEnemiesDead);
@@ -45,6 +42,9 @@ class HYPERCUBE_API ABase_LevelController : public AActor
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Components, meta = (AllowPrivateAccess = "true"))
 	class UAudioComponent* MusicComp_High;
 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Components, meta = (AllowPrivateAccess = "true"))
+	class UBase_AudioBudgetComponent* AudioBudget;
+
 public:	
 	// Sets default values for this actor's properties
 	ABase_LevelController();
@@ -64,28 +64,68 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = SaveGame)
 	FLevelData CurLevelData;
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = SaveGame)
+	int ScoreboardCapacity;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = SaveGame)
+	FRunAggregates RunAggregates;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = SaveGame)
+	float RollingStatsWeight;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Stats)
 	float AfterPlayerDeathTime;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Stats)
 	float FewEnemiesEventPercentage;
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Spawn)
+	ESpawnSelectionMode SpawnSelectionMode;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Spawn)
+	float SpawnStratumSize;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Spawn)
+	int MaxEnemiesPerStratum; // 0 for no cap
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Spawn)
+	int SpawnSeed; // 0 for a new seed every run
+
+	// same seed, difficulty and timestep on every run; also enabled with -HypercubeSeed=N on the command line
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Determinism)
+	bool bDeterministic;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Determinism)
+	int DeterministicSeed;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Determinism)
+	float DeterministicDifficulty;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Determinism)
+	float FixedTimestep; // 0 keeps the variable timestep
+
+	// enemy spawned by -HypercubeScalingBenchmark, the first enemy class of the level when empty
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Benchmark)
+	TSubclassOf<class ABase_NPC_SimpleChase> BenchmarkEnemyClass;
+
+	// throttles of blueprints that play enemy sounds themselves: the SetXSoundTurnOff setters note the sound in AudioBudget
+	// and hold the flag false for the category's TurnOffTime, or its MinInterval if that is longer
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Stats)
 	float NoticeSoundTurnOffTime;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Stats)
-	bool bEnemyCanNoticeSound;
-
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Stats)
 	float FootstepSoundTurnOffTime;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Stats)
-	bool bEnemyCanFootstepSound;
-
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Stats)
 	float DeathSoundTurnOffTime;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Stats)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Stats, meta = (DeprecatedProperty, DeprecationMessage = "Use RequestEnemySound"))
+	bool bEnemyCanNoticeSound;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Stats, meta = (DeprecatedProperty, DeprecationMessage = "Use RequestEnemySound"))
+	bool bEnemyCanFootstepSound;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Stats, meta = (DeprecatedProperty, DeprecationMessage = "Use RequestEnemySound"))
 	bool bEnemyCanDeathSound;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Stats)
@@ -127,6 +167,9 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Adaptive difficulty | Output parameters")
 	TArray<float> DifficultyParameterBounds;
 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Adaptive difficulty | Output parameters")
+	FDifficultyParams DifficultyParams;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Adaptive difficulty | Output parameters | Player")
 	TArray<float> PlayerVelocityValues;
 
@@ -152,12 +195,16 @@ public:
 	float MusicParameter;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Music")
-	float MusicChangeSpeed;
+	float MusicFadeTime;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Music")
+	// the parameter the music is fading to, equal to MusicParameter now that the fade runs on the sounds
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Music", meta = (DeprecatedProperty, DeprecationMessage = "Use MusicParameter"))
 	float TargetMusicParameter;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Music")
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Music", meta = (DeprecatedProperty, DeprecationMessage = "Unused, the crossfade takes MusicFadeTime"))
+	float MusicChangeSpeed;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Music", meta = (DeprecatedProperty, DeprecationMessage = "Unused, the music follows chasing count changes"))
 	float MusicRefreshFrequency;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Music")
@@ -169,47 +216,110 @@ protected:
 
 	class AHypercubeCharacter* Player;
 	
-	TArray<class AActor*> SpawnPoints;
+	TArray<FEnemySpawnRecord> SpawnRecords;
+	TArray<UClass*> SpawnEnemyClasses;
+	FSpawnStrata SpawnStrata;
+	FRandomStream SpawnStream;
+	FRandomStream UnstuckStream;
+
+	bool bFixedTimestepApplied;
+	double PreviousFixedDeltaTime;
+
+	// a live recorded session runs on the fixed timestep for the replay, so frames are held to real time
+	FDelegateHandle RecordingThrottleHandle;
+	double RecordingFrameStart;
+	void ThrottleRecording();
+
+	UPROPERTY()
+	class UBase_InputRecorderComponent* InputRecorder;
+
+	UPROPERTY()
+	class UBase_BotComponent* Bot;
+
+	UPROPERTY()
+	class UBase_ScalingBenchmarkComponent* ScalingBenchmark;
+
+	int32 RunSeed;
+
+	void InitDeterminism();
+
+	void CollectSpawnRecords();
 
 	int BeginEnemyCount;
 	int EnemiesKilled;
 	int FewEnemiesEventCount;
-	TSet<class ABase_NPC_SimpleChase*> Enemies;
+	FEnemyRegistry EnemyRegistry;
 
 	FTimerHandle AfterLevelTimerHandle;
 
-	float MusicRefreshTimer;
+	FScoreboardIndex Scoreboard;
 
-	TArray<FScoreboardData> Scores;
+	FAdaptiveDifficultyModel DifficultyModel;
 
+	void CompileDifficultyCurves();
+	void UpdateDifficultyParams();
+
+	FString DifficultyBrief;
+	void BuildDifficultyBrief();
+
+	virtual void PostInitializeComponents() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
 	virtual void BeginPlay() override;
-	virtual void Tick(float DeltaSeconds) override;
-	//virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	int GetCurMapIndex() const;
 
-	void ReadScoreboardData();
+	bool bLevelDataLoaded;
+	bool bLevelDataLoading;
 
-	FTimerHandle NoticeSoundTurnOffTimerHandle;
-	void OnEndNoticeSoundTurnedOff();
+	void ReadScoreboardData();
+	FString GetSummarySlotName() const;
+	void EnsureLevelDataLoaded();
 
-	FTimerHandle FootstepSoundTurnOffTimerHandle;
-	void OnEndFootstepSoundTurnedOff();
+	FTimerHandle LegacySoundTimerHandles[int(EEnemySoundCategory::Count)];
+	bool& GetLegacySoundFlag(EEnemySoundCategory Category);
+	float GetLegacySoundTurnOffTime(EEnemySoundCategory Category) const;
+	void TurnOffLegacySound(EEnemySoundCategory Category);
+	void OnEndLegacySoundTurnOff(EEnemySoundCategory Category);
+	void RequestLevelData(); // starts the async load of the full history
+	void OnLevelDataLoaded(const FString& SlotName, const int32 UserIndex, class USaveGame* SaveGame);
+	void ApplyLevelData(class UBase_RunDataSave* LoadedData);
 
-	FTimerHandle DeathSoundTurnOffTimerHandle;
-	void OnEndDeathSoundTurnedOff();
+	void OnEnemyChasingCountChanged(int ChasingCount);
+	void SetMusicParameter(float NewParameter, float FadeTime);
 
 public:	
 
+	UFUNCTION(BlueprintCallable)
+	void LoadRunSummary();
+
 	UFUNCTION(BlueprintCallable)
 	void LoadLevelData();
 
+	// the full history, loaded in the background from BeginPlay; loads it synchronously if that has not finished yet
+	UFUNCTION(BlueprintCallable)
+	const TArray<FLevelData>& GetLevelData();
+
+	FEnemyRegistry& GetEnemyRegistry();
+	FRandomStream& GetSpawnStream();
+	FRandomStream& GetUnstuckStream();
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	bool IsDeterministic() const;
+
 	UFUNCTION(BlueprintCallable)
 	void SpawnEnemies();
 
 	UFUNCTION(BlueprintCallable)
 	void SpawnEnemy(class ABase_EnemySpawnPoint* SpawnPoint);
 
+	UFUNCTION(BlueprintCallable)
+	class ABase_NPC_SimpleChase* SpawnEnemyAt(TSubclassOf<class ABase_NPC_SimpleChase> EnemyClass, FVector Location, FRotator Rotation);
+
+	TSubclassOf<class ABase_NPC_SimpleChase> GetBenchmarkEnemyClass() const;
+
 	UFUNCTION(BlueprintCallable)
 	void SetPlayerCharacter(class AHypercubeCharacter* PlayerCharacter);
 
@@ -222,6 +332,9 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void RemoveEnemy(class ABase_NPC_SimpleChase* Enemy);
 
+	// the remaining-enemy events fire once for the whole batch
+	void RemoveEnemies(TArrayView<class ABase_NPC_SimpleChase* const> Enemies);
+
 	UFUNCTION(BlueprintCallable)
 	void UpdateMaxMultiplicator(float NewMultiplicator);
 
@@ -247,17 +360,26 @@ public:
 	void LoadNextLevel();
 
 	UFUNCTION(BlueprintCallable)
+	void RequestEnemySound(EEnemySoundCategory Category, class USoundBase* Sound, FVector Location);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	class UBase_AudioBudgetComponent* GetAudioBudget() const;
+
+	UFUNCTION(BlueprintCallable, meta = (DeprecatedFunction, DeprecationMessage = "Use RequestEnemySound"))
 	void SetNoticeSoundTurnOff();
 
-	UFUNCTION(BlueprintCallable)
+	UFUNCTION(BlueprintCallable, meta = (DeprecatedFunction, DeprecationMessage = "Use RequestEnemySound"))
 	void SetFootstepSoundTurnOff();
 
-	UFUNCTION(BlueprintCallable)
+	UFUNCTION(BlueprintCallable, meta = (DeprecatedFunction, DeprecationMessage = "Use RequestEnemySound"))
 	void SetDeathSoundTurnOff();
 
 	UFUNCTION(BlueprintCallable)
 	float GetDifficultyParameter();
 
+	FAdaptiveDifficultyModel BuildDifficultyModel() const;
+	FDifficultyParams ResolveDifficultyParams(const FDifficultyOutputTable& OutputTable, int Index) const;
+
 	UFUNCTION(BlueprintCallable)
 	void SetPlayerParams();
 
@@ -267,6 +389,9 @@ public:
 	UFUNCTION(BlueprintCallable)
 	float GetTargetMusicParameter();
 
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	FScoreboardView GetScoreboardView(int Num);
+
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	FString GetScoreboard(int Num);
 
@@ -287,83 +412,4 @@ public:
 
 };
 
-template<typename T>
-int GetAsc(const TArray<T>& Arr) // returns 1 when array is increasing, -1 when decreasing, else 0
-{
-	if (Arr.Num() < 2)
-	{
-		return 1;
-	}
-	bool Asc = Arr[0] < Arr.Last();
-	if (Asc)
-	{
-		for (int i = 0; i < Arr.Num() - 1; ++i)
-		{
-			if (Arr[i] > Arr[i + 1])
-			{
-				return 0;
-			}
-		}
-	}
-	else
-	{
-		for (int i = 0; i < Arr.Num() - 1; ++i)
-		{
-			if (Arr[i] < Arr[i + 1])
-			{
-				return 0;
-			}
-		}
-	}
-	return Asc ? 1 : -1;
-}
-
-template<typename T>
-float GetDifficultyParameterFrom(T Val, const TArray<T>& Bounds, const TArray<float>& Values) // returns unscaled difficulty parameter from given bounds and parameter values arrays
-{
-	if (Bounds.Num() != Values.Num())
-	{
-		UE_LOG(LogTemp, Error, TEXT("Adaptive difficulty: Bounds array must be the same length as values array!"));
-		return 0.5f;
-	}
-	if (!GetAsc(Bounds) || !GetAsc(Values))
-	{
-		UE_LOG(LogTemp, Error, TEXT("Adaptive difficulty: Bounds and values arrays must be monotone"));
-		return 0.5f;
-	}
-	bool BoundsAsc = Bounds[0] < Bounds.Last();
-	bool ValuesAsc = Values[0] < Values.Last();
-	for (int i = 0; i < Bounds.Num(); ++i)
-	{
-		if ((BoundsAsc && Val < Bounds[i]) || (!BoundsAsc && Val > Bounds[i]))
-		{
-			return Values[i];
-		}
-	}
-	return ValuesAsc ? 1.0f : 0.0f;
-}
-
-template<typename T>
-T GetOutputParameterFrom(float Val, const TArray<float>& Bounds, const TArray<T>& Values) // returns game parameter from given difficulty parameter, bounds and values arrays
-{
-	if (Bounds.Num() != Values.Num())
-	{
-		UE_LOG(LogTemp, Error, TEXT("Adaptive difficulty: Bounds array must be the same length as values array!"));
-		return T();
-	}
-	if (GetAsc(Bounds) != 1)
-	{
-		UE_LOG(LogTemp, Error, TEXT("Adaptive difficulty: Bounds array must be monotone"));
-		return T();
-	}
-	for (int i = 1; i < Bounds.Num(); ++i)
-	{
-		if (Val < Bounds[i])
-		{
-			return Values[i - 1];
-		}
-	}
-	return Values.Last();
-}
-
 FString FloatToFString(float Val);
\ No newline at end of file
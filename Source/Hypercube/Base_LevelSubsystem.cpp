@@ -0,0 +1,325 @@
+#include "Base_LevelSubsystem.h"
+#include "Hypercube.h"
+#include "Base_LevelController.h"
+#include "Base_EnemySpawnPoint.h"
+#include "Base_EnemySpawnSet.h"
+#include "Base_NPC_SimpleChase.h"
+#include "NavigationSystem.h"
+#include "NavigationData.h"
+#include "HypercubeCharacter.h"
+#include "HypercubeStats.h"
+#include "HypercubeAllocTracker.h"
+#include "Kismet/GameplayStatics.h"
+#include "HypercubeEventLog.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/DateTime.h"
+
+namespace
+{
+	TAutoConsoleVariable<float> CVarHitchThresholdMs(
+		TEXT("hypercube.HitchThresholdMs"),
+		100.0f,
+		TEXT("Frames longer than this append a gameplay snapshot to Saved/Hitches, 0 disables hitch detection"));
+
+	TAutoConsoleVariable<float> CVarHitchEventDumpInterval(
+		TEXT("hypercube.HitchEventDumpInterval"),
+		30.0f,
+		TEXT("Minimum seconds between gameplay event dumps triggered by hitches, 0 never dumps"));
+
+	const int64 HitchFileMaxBytes = 512 * 1024;
+	const int32 HitchFileGenerations = 3;
+
+	FAutoConsoleCommandWithWorld ToggleOverlayCommand(
+		TEXT("Hypercube.Overlay"),
+		TEXT("Shows or hides the gameplay performance overlay"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (UBase_LevelSubsystem* LevelSubsystem = UBase_LevelSubsystem::Get(World))
+			{
+				LevelSubsystem->ToggleOverlay();
+			}
+		}));
+}
+
+UBase_LevelSubsystem::UBase_LevelSubsystem()
+{
+	LevelController = nullptr;
+	LastTickTime = 0.0;
+	LastHitchDumpTime = -MAX_dbl;
+	NavQueriesThisFrame = 0;
+	LastSaveTime = -1.0;
+	LastSpawnBatchTime = -1.0;
+	LastSpawnBatchFrame = 0;
+	LastSpawnBatch = 0;
+	LastTickFrame = 0;
+}
+
+UBase_LevelSubsystem* UBase_LevelSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UBase_LevelSubsystem>() : nullptr;
+}
+
+void UBase_LevelSubsystem::RegisterLevelController(class ABase_LevelController* Controller)
+{
+	if (LevelController && LevelController != Controller)
+	{
+		UE_LOG(LogHypercube, Warning, TEXT("More than one level controller in %s"), *GetWorld()->GetMapName());
+		return;
+	}
+	LevelController = Controller;
+	for (ABase_NPC_SimpleChase* Enemy : PendingEnemies)
+	{
+		if (IsValid(Enemy))
+		{
+			RegisterEnemy(Enemy);
+		}
+	}
+	PendingEnemies.Empty();
+}
+
+void UBase_LevelSubsystem::UnregisterLevelController(class ABase_LevelController* Controller)
+{
+	if (LevelController == Controller)
+	{
+		LevelController = nullptr;
+	}
+}
+
+void UBase_LevelSubsystem::RegisterSpawnPoint(class ABase_EnemySpawnPoint* SpawnPoint)
+{
+	SpawnPoints.AddUnique(SpawnPoint);
+}
+
+void UBase_LevelSubsystem::UnregisterSpawnPoint(class ABase_EnemySpawnPoint* SpawnPoint)
+{
+	SpawnPoints.RemoveSwap(SpawnPoint);
+}
+
+void UBase_LevelSubsystem::RegisterSpawnSet(class ABase_EnemySpawnSet* SpawnSet)
+{
+	SpawnSets.AddUnique(SpawnSet);
+}
+
+void UBase_LevelSubsystem::UnregisterSpawnSet(class ABase_EnemySpawnSet* SpawnSet)
+{
+	SpawnSets.RemoveSwap(SpawnSet);
+}
+
+void UBase_LevelSubsystem::RegisterEnemy(class ABase_NPC_SimpleChase* Enemy)
+{
+	if (!LevelController)
+	{
+		PendingEnemies.AddUnique(Enemy);
+		return;
+	}
+	if (!Enemy->LevelController)
+	{
+		Enemy->LevelController = LevelController;
+	}
+	Enemy->LevelController->AddEnemy(Enemy);
+}
+
+class ABase_LevelController* UBase_LevelSubsystem::GetLevelController() const
+{
+	return LevelController;
+}
+
+const TArray<class ABase_EnemySpawnPoint*>& UBase_LevelSubsystem::GetSpawnPoints() const
+{
+	return SpawnPoints;
+}
+
+const TArray<class ABase_EnemySpawnSet*>& UBase_LevelSubsystem::GetSpawnSets() const
+{
+	return SpawnSets;
+}
+
+// nav data is owned by the navigation system, so it is resolved on first use instead of registering
+class ANavigationData* UBase_LevelSubsystem::GetNavData()
+{
+	if (!NavData.IsValid())
+	{
+		UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+		NavData = NavSys ? NavSys->GetDefaultNavDataInstance(FNavigationSystem::DontCreate) : nullptr;
+	}
+	return NavData.Get();
+}
+
+void UBase_LevelSubsystem::Deinitialize()
+{
+	LevelController = nullptr;
+	SpawnPoints.Empty();
+	SpawnSets.Empty();
+	PendingEnemies.Empty();
+	NavData.Reset();
+	Overlay.Show(false);
+#if HYPERCUBE_DEBUG_DRAW
+	DebugDraw.Reset();
+#endif
+	Super::Deinitialize();
+}
+
+void UBase_LevelSubsystem::NoteNavQueries(int32 Count)
+{
+	NavQueriesThisFrame += Count;
+}
+
+void UBase_LevelSubsystem::NoteSave()
+{
+	LastSaveTime = FPlatformTime::Seconds();
+}
+
+// spawns within one frame count as one batch
+void UBase_LevelSubsystem::NoteEnemySpawned()
+{
+	if (LastSpawnBatchFrame != GFrameCounter)
+	{
+		LastSpawnBatchFrame = GFrameCounter;
+		LastSpawnBatchTime = FPlatformTime::Seconds();
+		LastSpawnBatch = 0;
+	}
+	++LastSpawnBatch;
+}
+
+FGameplaySnapshot UBase_LevelSubsystem::CaptureSnapshot() const
+{
+	FGameplaySnapshot Snapshot = {};
+	const double Now = FPlatformTime::Seconds();
+	Snapshot.NavQueries = NavQueriesThisFrame;
+	Snapshot.SecondsSinceSave = LastSaveTime < 0.0 ? -1.0f : float(Now - LastSaveTime);
+	Snapshot.LastSpawnBatch = LastSpawnBatch;
+	Snapshot.SecondsSinceSpawnBatch = LastSpawnBatchTime < 0.0 ? -1.0f : float(Now - LastSpawnBatchTime);
+	if (!LevelController)
+	{
+		return Snapshot;
+	}
+	const FEnemyRegistry& Registry = LevelController->GetEnemyRegistry();
+	for (const FEnemyHotData& Enemy : Registry.GetAllHotData())
+	{
+		++Snapshot.EnemiesByPhase[FMath::Min(int(Enemy.Phase), 2)];
+	}
+	for (const ABase_NPC_SimpleChase* Enemy : Registry.GetAllEnemies())
+	{
+		++Snapshot.EnemiesByAttackPhase[FMath::Min(int(Enemy->GetAttackPhase()), 3)];
+		Snapshot.TickingEnemies += Enemy->IsTickRequested() ? 1 : 0;
+		Snapshot.ActiveTimers += Enemy->CountActiveTimers();
+		Snapshot.PendingUnstuck += Enemy->IsUnstuckPending() ? 1 : 0;
+	}
+	if (const AHypercubeCharacter* Player = Cast<AHypercubeCharacter>(UGameplayStatics::GetPlayerCharacter(this, 0)))
+	{
+		Snapshot.ActiveTimers += Player->CountActiveTimers();
+	}
+	return Snapshot;
+}
+
+void UBase_LevelSubsystem::WriteHitch(float FrameMs, const FGameplaySnapshot& Snapshot)
+{
+	const FString Dir = FPaths::ProjectSavedDir() / TEXT("Hitches");
+	const FString Path = Dir / TEXT("Hitches.csv");
+	IFileManager& FileManager = IFileManager::Get();
+	if (FileManager.FileSize(*Path) > HitchFileMaxBytes)
+	{
+		for (int32 i = HitchFileGenerations - 1; i > 0; --i)
+		{
+			const FString From = i > 1 ? Dir / FString::Printf(TEXT("Hitches.%d.csv"), i - 1) : Path;
+			FileManager.Move(*(Dir / FString::Printf(TEXT("Hitches.%d.csv"), i)), *From, true, true);
+		}
+	}
+	FString Line;
+	if (FileManager.FileSize(*Path) <= 0)
+	{
+		Line = TEXT("Time,Map,FrameMs,Idle,Noticing,Chasing,NotAttacking,Opener,Attacking,AfterAttack,Ticking,Timers,PendingUnstuck,NavQueries,SinceSave,LastSpawnBatch,SinceSpawnBatch\n");
+	}
+	Line += FString::Printf(TEXT("%s,%s,%.1f,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%.1f,%d,%.1f\n"),
+		*FDateTime::Now().ToString(), *GetWorld()->GetMapName(), FrameMs,
+		Snapshot.EnemiesByPhase[0], Snapshot.EnemiesByPhase[1], Snapshot.EnemiesByPhase[2],
+		Snapshot.EnemiesByAttackPhase[0], Snapshot.EnemiesByAttackPhase[1], Snapshot.EnemiesByAttackPhase[2], Snapshot.EnemiesByAttackPhase[3],
+		Snapshot.TickingEnemies, Snapshot.ActiveTimers, Snapshot.PendingUnstuck, Snapshot.NavQueries,
+		Snapshot.SecondsSinceSave, Snapshot.LastSpawnBatch, Snapshot.SecondsSinceSpawnBatch);
+	FFileHelper::SaveStringToFile(Line, *Path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM, &FileManager, FILEWRITE_Append);
+
+	FHypercubeEventLog::Record(EHypercubeEvent::Hitch, this, FrameMs);
+	const float DumpInterval = CVarHitchEventDumpInterval.GetValueOnGameThread();
+	const double Now = FPlatformTime::Seconds();
+	if (DumpInterval > 0.0f && Now - LastHitchDumpTime > DumpInterval)
+	{
+		LastHitchDumpTime = Now;
+		FHypercubeEventLog::Dump(TEXT("Hitch"));
+	}
+}
+
+bool UBase_LevelSubsystem::IsTickable() const
+{
+	return LevelController && !IsTemplate();
+}
+
+// the frame is measured between two ticks, so it covers everything the game thread waited on in between
+void UBase_LevelSubsystem::Tick(float DeltaTime)
+{
+	// the subsystem doesn't tick while the world is paused, so a gap in frames means a pause, not a long frame
+	const double Now = FPlatformTime::Seconds();
+	const bool bConsecutiveTick = LastTickTime > 0.0 && GFrameCounter == LastTickFrame + 1;
+	const float FrameMs = bConsecutiveTick ? float((Now - LastTickTime) * 1000.0) : 0.0f;
+	LastTickTime = Now;
+	LastTickFrame = GFrameCounter;
+	const float HitchMs = CVarHitchThresholdMs.GetValueOnGameThread();
+	const bool bHitch = HitchMs > 0.0f && FrameMs > HitchMs;
+#if STATS
+	const bool bStats = FThreadStats::IsCollectingData();
+#else
+	const bool bStats = false;
+#endif
+	if (bHitch || bStats)
+	{
+		const FGameplaySnapshot Snapshot = CaptureSnapshot();
+		SET_DWORD_STAT(STAT_Hypercube_EnemiesIdle, Snapshot.EnemiesByPhase[0]);
+		SET_DWORD_STAT(STAT_Hypercube_EnemiesNoticing, Snapshot.EnemiesByPhase[1]);
+		SET_DWORD_STAT(STAT_Hypercube_EnemiesChasing, Snapshot.EnemiesByPhase[2]);
+		SET_DWORD_STAT(STAT_Hypercube_TickingEnemies, Snapshot.TickingEnemies);
+		SET_DWORD_STAT(STAT_Hypercube_ActiveTimers, Snapshot.ActiveTimers);
+#if HYPERCUBE_ALLOC_TRACKING
+		SET_DWORD_STAT(STAT_Hypercube_GameplayAllocs, FHypercubeAllocTracker::GetLastFrameAllocs());
+#endif
+		if (bHitch)
+		{
+			WriteHitch(FrameMs, Snapshot);
+		}
+	}
+	const AHypercubeCharacter* Player = Cast<AHypercubeCharacter>(UGameplayStatics::GetPlayerCharacter(this, 0));
+	if (Overlay.IsShown())
+	{
+		Overlay.EndFrame(LevelController->GetEnemyRegistry(), Player);
+	}
+#if HYPERCUBE_DEBUG_DRAW
+	DebugDraw.Draw(GetWorld(), LevelController->GetEnemyRegistry(), Player);
+#endif
+	FGameplayFrameCounters::Reset();
+	NavQueriesThisFrame = 0;
+}
+
+void UBase_LevelSubsystem::ToggleOverlay()
+{
+	Overlay.Show(!Overlay.IsShown());
+}
+
+#if HYPERCUBE_DEBUG_DRAW
+FGameplayDebugDraw& UBase_LevelSubsystem::GetDebugDraw()
+{
+	return DebugDraw;
+}
+#endif
+
+TStatId UBase_LevelSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBase_LevelSubsystem, STATGROUP_Tickables);
+}
+
+UWorld* UBase_LevelSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
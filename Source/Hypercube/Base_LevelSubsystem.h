@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "Base_GameplayOverlay.h"
+#include "Base_GameplayDebugDraw.h"
+#include "Base_LevelSubsystem.generated.h"
+
+// gameplay state sampled for stat Hypercube and written next to every hitch
+struct FGameplaySnapshot
+{
+	int32 EnemiesByPhase[3]; // EEnemyPhase
+	int32 EnemiesByAttackPhase[4]; // EAttackPhase
+	int32 TickingEnemies;
+	int32 ActiveTimers;
+	int32 PendingUnstuck;
+	int32 NavQueries; // since the previous frame
+	float SecondsSinceSave; // -1 before the first save
+	int32 LastSpawnBatch;
+	float SecondsSinceSpawnBatch; // -1 before the first spawn
+};
+
+// Per-world lookup for the actors gameplay code used to find by iterating the world.
+// Spawn points, spawn sets and the level controller register in PostInitializeComponents, so they are known before any BeginPlay;
+// enemies register in BeginPlay and are handed to the controller, or kept until it registers.
+// Every frame it also watches for hitches: a frame longer than hypercube.HitchThresholdMs appends a snapshot of
+// gameplay state to Saved/Hitches/Hitches.csv (rotated, a few generations kept) and dumps the gameplay event rings.
+// While stats are collected the same snapshot feeds the per-frame counters of stat Hypercube.
+// Outside Shipping it also owns the gameplay debug draw and draws it once per frame.
+UCLASS()
+class HYPERCUBE_API UBase_LevelSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UBase_LevelSubsystem();
+
+	static UBase_LevelSubsystem* Get(const UObject* WorldContextObject);
+
+	void RegisterLevelController(class ABase_LevelController* Controller);
+	void UnregisterLevelController(class ABase_LevelController* Controller);
+
+	void RegisterSpawnPoint(class ABase_EnemySpawnPoint* SpawnPoint);
+	void UnregisterSpawnPoint(class ABase_EnemySpawnPoint* SpawnPoint);
+
+	void RegisterSpawnSet(class ABase_EnemySpawnSet* SpawnSet);
+	void UnregisterSpawnSet(class ABase_EnemySpawnSet* SpawnSet);
+
+	void RegisterEnemy(class ABase_NPC_SimpleChase* Enemy);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	class ABase_LevelController* GetLevelController() const;
+
+	const TArray<class ABase_EnemySpawnPoint*>& GetSpawnPoints() const;
+	const TArray<class ABase_EnemySpawnSet*>& GetSpawnSets() const;
+
+	class ANavigationData* GetNavData();
+
+	void NoteNavQueries(int32 Count);
+	void NoteSave();
+	void NoteEnemySpawned();
+
+	FGameplaySnapshot CaptureSnapshot() const;
+
+	void ToggleOverlay();
+
+#if HYPERCUBE_DEBUG_DRAW
+	FGameplayDebugDraw& GetDebugDraw();
+#endif
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+protected:
+
+	UPROPERTY()
+	class ABase_LevelController* LevelController;
+
+	UPROPERTY()
+	TArray<class ABase_EnemySpawnPoint*> SpawnPoints;
+
+	UPROPERTY()
+	TArray<class ABase_EnemySpawnSet*> SpawnSets;
+
+	UPROPERTY()
+	TArray<class ABase_NPC_SimpleChase*> PendingEnemies;
+
+	TWeakObjectPtr<class ANavigationData> NavData;
+
+	double LastTickTime;
+	uint64 LastTickFrame;
+	double LastHitchDumpTime;
+	int32 NavQueriesThisFrame;
+	double LastSaveTime;
+	double LastSpawnBatchTime;
+	uint64 LastSpawnBatchFrame;
+	int32 LastSpawnBatch;
+
+	void WriteHitch(float FrameMs, const FGameplaySnapshot& Snapshot);
+
+	FGameplayOverlay Overlay;
+
+#if HYPERCUBE_DEBUG_DRAW
+	FGameplayDebugDraw DebugDraw;
+#endif
+};
@@ -0,0 +1,174 @@
+#include "Base_MigrateEnemyTuningCommandlet.h"
+#include "Base_NPC_SimpleChase.h"
+#include "Base_EnemyArchetype.h"
+#include "Hypercube.h"
+
+#if WITH_EDITOR
+#include "AssetRegistryModule.h"
+#include "Engine/Blueprint.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#endif
+
+namespace MigrateEnemyTuning
+{
+#if WITH_EDITOR
+	static bool Save(UPackage* Package, UObject* Asset)
+	{
+		Package->MarkPackageDirty();
+		const FString Extension = Asset->IsA<UWorld>() ? FPackageName::GetMapPackageExtension() : FPackageName::GetAssetPackageExtension();
+		const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), Extension);
+		if (!UPackage::SavePackage(Package, Asset, RF_Standalone, *Filename, GError, nullptr, false, true, SAVE_NoError))
+		{
+			UE_LOG(LogHypercube, Error, TEXT("Enemy tuning migration: can not save %s"), *Filename);
+			return false;
+		}
+		UE_LOG(LogHypercube, Display, TEXT("Enemy tuning migration: saved %s"), *Filename);
+		return true;
+	}
+
+	// writes the legacy tuning of Enemy into the archetype asset at PackageName, reusing the asset of an earlier run
+	static UBase_EnemyArchetype* WriteArchetype(const ABase_NPC_SimpleChase* Enemy, const FString& PackageName)
+	{
+		const FString AssetName = FPackageName::GetShortName(PackageName);
+		UBase_EnemyArchetype* Tuning = LoadObject<UBase_EnemyArchetype>(nullptr, *(PackageName + TEXT(".") + AssetName), nullptr, LOAD_NoWarn | LOAD_Quiet);
+		if (!Tuning)
+		{
+			Tuning = NewObject<UBase_EnemyArchetype>(CreatePackage(*PackageName), *AssetName, RF_Public | RF_Standalone);
+			FAssetRegistryModule::AssetCreated(Tuning);
+		}
+		Tuning->JumpTime = Enemy->JumpTime;
+		Tuning->AggroRadius = Enemy->AggroRadius;
+		Tuning->AggroTime = Enemy->AggroTime;
+		Tuning->SimpleAttack = Enemy->SimpleAttack;
+		Tuning->UnstuckPlayerSightUpdate = Enemy->UnstuckPlayerSightUpdate;
+		Tuning->UnstuckAroundPlayerRadius = Enemy->UnstuckAroundPlayerRadius;
+		Tuning->MaxAttempsToUnstuck = Enemy->MaxAttempsToUnstuck;
+		Tuning->Debug_DamageIndicatorTime = Enemy->Debug_DamageIndicatorTime;
+		return Save(Tuning->GetOutermost(), Tuning) ? Tuning : nullptr;
+	}
+
+	static int32 GetDepth(const UClass* Class)
+	{
+		int32 Depth = 0;
+		for (; Class; Class = Class->GetSuperClass())
+		{
+			++Depth;
+		}
+		return Depth;
+	}
+#endif
+}
+
+UBase_MigrateEnemyTuningCommandlet::UBase_MigrateEnemyTuningCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UBase_MigrateEnemyTuningCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	using namespace MigrateEnemyTuning;
+
+	const bool bDryRun = FParse::Param(*Params, TEXT("DryRun"));
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	// parents first, so a child blueprint that kept its parent's tuning gets the parent's asset
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssetsByClass(UBlueprint::StaticClass()->GetFName(), Assets, true);
+	TArray<UBlueprint*> Blueprints;
+	for (const FAssetData& Asset : Assets)
+	{
+		UBlueprint* Blueprint = Cast<UBlueprint>(Asset.GetAsset());
+		if (Blueprint && Blueprint->GeneratedClass && Blueprint->GeneratedClass->IsChildOf(ABase_NPC_SimpleChase::StaticClass()))
+		{
+			Blueprints.Add(Blueprint);
+		}
+	}
+	Blueprints.Sort([](const UBlueprint& A, const UBlueprint& B) { return GetDepth(A.GeneratedClass) < GetDepth(B.GeneratedClass); });
+
+	int32 Migrated = 0;
+	for (UBlueprint* Blueprint : Blueprints)
+	{
+		ABase_NPC_SimpleChase* Defaults = Blueprint->GeneratedClass->GetDefaultObject<ABase_NPC_SimpleChase>();
+		const ABase_NPC_SimpleChase* Parent = Blueprint->GeneratedClass->GetSuperClass()->GetDefaultObject<ABase_NPC_SimpleChase>();
+		if (Defaults->Archetype)
+		{
+			continue;
+		}
+		const bool bOwnTuning = !Defaults->MatchesLegacyTuning(Parent->GetArchetype());
+		if (!bOwnTuning && !Parent->Archetype)
+		{
+			continue; // plays the same with the default archetype
+		}
+		UE_LOG(LogHypercube, Display, TEXT("Enemy tuning migration: %s %s"), *Blueprint->GetPathName(),
+			bOwnTuning ? TEXT("gets an archetype of its own") : TEXT("takes its parent's archetype"));
+		if (bDryRun)
+		{
+			++Migrated;
+			continue;
+		}
+		UBase_EnemyArchetype* Tuning = bOwnTuning ? WriteArchetype(Defaults, TEXT("/Game/NPCs/") + Blueprint->GetName() + TEXT("_Archetype")) : Parent->Archetype;
+		if (!Tuning)
+		{
+			return 1;
+		}
+		Defaults->Archetype = Tuning;
+		if (!Save(Blueprint->GetOutermost(), Blueprint))
+		{
+			return 1;
+		}
+		++Migrated;
+	}
+
+	// maps are loaded after the blueprints were migrated, so placed enemies already see their class's archetype
+	Assets.Reset();
+	AssetRegistry.GetAssetsByClass(UWorld::StaticClass()->GetFName(), Assets, true);
+	for (const FAssetData& Asset : Assets)
+	{
+		UWorld* World = Cast<UWorld>(Asset.GetAsset());
+		if (!World || !World->PersistentLevel)
+		{
+			continue;
+		}
+		bool bChanged = false;
+		for (AActor* Actor : World->PersistentLevel->Actors)
+		{
+			ABase_NPC_SimpleChase* Enemy = Cast<ABase_NPC_SimpleChase>(Actor);
+			if (!Enemy || Enemy->MatchesLegacyTuning(Enemy->GetArchetype()))
+			{
+				continue;
+			}
+			UE_LOG(LogHypercube, Display, TEXT("Enemy tuning migration: %s gets an archetype of its own"), *Enemy->GetPathName());
+			++Migrated;
+			if (bDryRun)
+			{
+				continue;
+			}
+			UBase_EnemyArchetype* Tuning = WriteArchetype(Enemy, FString::Printf(TEXT("/Game/NPCs/%s_%s_Archetype"), *World->GetName(), *Enemy->GetName()));
+			if (!Tuning)
+			{
+				return 1;
+			}
+			Enemy->Archetype = Tuning;
+			bChanged = true;
+		}
+		if (bChanged && !Save(World->GetOutermost(), World))
+		{
+			return 1;
+		}
+	}
+
+	UE_LOG(LogHypercube, Display, TEXT("Enemy tuning migration: %d enemy blueprints and placed enemies %s"), Migrated, bDryRun ? TEXT("to migrate") : TEXT("migrated"));
+	return 0;
+#else
+	UE_LOG(LogHypercube, Error, TEXT("Enemy tuning migration needs the editor"));
+	return 1;
+#endif
+}
@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Base_MigrateEnemyTuningCommandlet.generated.h"
+
+// Moves the enemy tuning from before archetypes into UBase_EnemyArchetype assets under /Game/NPCs, once.
+// Every enemy blueprint without an archetype whose legacy tuning differs from its parent's gets an asset of its own,
+// then enemies placed in maps with their own tuning get one each. Blueprints, maps and assets are saved in place;
+// an asset that already exists is overwritten, so the commandlet can be run again.
+//
+// UE4Editor-Cmd Hypercube.uproject -run=Base_MigrateEnemyTuning [-DryRun]
+UCLASS()
+class UBase_MigrateEnemyTuningCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UBase_MigrateEnemyTuningCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -5,6 +5,7 @@
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Components/BoxComponent.h"
+#include "Components/StaticMeshComponent.h"
 #include "Math/UnrealMathVectorCommon.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Kismet/GameplayStatics.h"
@@ -12,8 +13,13 @@
 #include "Components/SphereComponent.h"
 #include "Base_LevelController.h"
 #include "Components/WidgetComponent.h"
-#include "NavMesh/RecastNavMesh.h"
-#include "NavigationSystem.h"
+#include "Base_LevelSubsystem.h"
+#include "NavigationData.h"
+#include "HypercubeStats.h"
+#include "HypercubeAllocTracker.h"
+#include "HypercubeEventLog.h"
+#include "Base_GameplayDebugDraw.h"
+#include "Hypercube.h"
 
 // Sets default values
 ABase_NPC_SimpleChase::ABase_NPC_SimpleChase()
@@ -33,53 +39,55 @@ ABase_NPC_SimpleChase::ABase_NPC_SimpleChase()
 
 	Health = MaxHealth = 100.0f;
 
-	JumpTime = 2.0f;
-
-	AggroRadius = 800.0f;
-	AggroTime = 0.5f;
+	// the collision shapes start from the default archetype, PostInitializeComponents applies the assigned one
+	Archetype = nullptr;
+	const UBase_EnemyArchetype* Defaults = GetDefault<UBase_EnemyArchetype>();
+	const FAttackStats& DefaultAttack = Defaults->SimpleAttack;
+	Overrides = { DefaultAttack.Damage, Defaults->AggroRadius };
+
+#if WITH_EDITORONLY_DATA
+	JumpTime = Defaults->JumpTime;
+	AggroRadius = Defaults->AggroRadius;
+	AggroTime = Defaults->AggroTime;
+	SimpleAttack = DefaultAttack;
+	UnstuckPlayerSightUpdate = Defaults->UnstuckPlayerSightUpdate;
+	UnstuckAroundPlayerRadius = Defaults->UnstuckAroundPlayerRadius;
+	MaxAttempsToUnstuck = Defaults->MaxAttempsToUnstuck;
+	Debug_DamageIndicatorTime = Defaults->Debug_DamageIndicatorTime;
+#endif
 
 	NoticeCollision = CreateAbstractDefaultSubobject<USphereComponent>(TEXT("Notice Collision"));
 	NoticeCollision->AttachTo(RootComponent);
-	NoticeCollision->SetSphereRadius(AggroRadius);
+	NoticeCollision->SetSphereRadius(Overrides.AggroRadius);
 	NoticeCollision->SetGenerateOverlapEvents(false);
 
-	SimpleAttack = { 25.0f, 0.7f, 0.3f, 0.2f, 7.5f, 150.0f, 75.0f, 35.0f };
-
 	AttackCollision = CreateDefaultSubobject<UBoxComponent>(TEXT("AttackCollision"));
 	AttackCollision->AttachTo(RootComponent);
-	AttackCollision->SetRelativeLocation(FVector((Capsule->GetScaledCapsuleRadius() + SimpleAttack.AttackLength) / 2.0f, 0.0f, 20.0f));
-	AttackCollision->SetBoxExtent(FVector(SimpleAttack.AttackLength - Capsule->GetScaledCapsuleRadius(), SimpleAttack.AttackWidth, 32.0f));
+	AttackCollision->SetRelativeLocation(FVector((Capsule->GetScaledCapsuleRadius() + DefaultAttack.AttackLength) / 2.0f, 0.0f, 20.0f));
+	AttackCollision->SetBoxExtent(FVector(DefaultAttack.AttackLength - Capsule->GetScaledCapsuleRadius(), DefaultAttack.AttackWidth, 32.0f));
 	AttackCollision->SetGenerateOverlapEvents(true);
 	AttackCollision->SetHiddenInGame(false);
 	AttackCollision->SetVisibility(false);
 	AttackCollision->SetActive(false);
 
+	Debug_AttackCollision = nullptr;
+	Debug_DamageIndicator = nullptr;
+#if WITH_EDITORONLY_DATA
 	Debug_AttackCollision = CreateDefaultSubobject<UBoxComponent>(TEXT("DebugAttackCollision"));
 	Debug_AttackCollision->AttachTo(RootComponent);
-	Debug_AttackCollision->SetRelativeLocation(FVector((Capsule->GetScaledCapsuleRadius() + SimpleAttack.AttackLength) / 2.0f, 0.0f, 20.0f));
-	Debug_AttackCollision->SetBoxExtent(FVector(SimpleAttack.AttackLength - Capsule->GetScaledCapsuleRadius(), SimpleAttack.AttackWidth, 32.0f));
-	Debug_AttackCollision->SetGenerateOverlapEvents(false);
-	Debug_AttackCollision->SetHiddenInGame(false);
-	Debug_AttackCollision->SetVisibility(false);
-	Debug_AttackCollision->SetActive(false);
+	Debug_AttackCollision->bAutoRegister = false;
+	Debug_AttackCollision->bIsEditorOnly = true;
+
+	Debug_DamageIndicator = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Debug Damage Indicator"));
+	Debug_DamageIndicator->AttachTo(RootComponent);
+	Debug_DamageIndicator->bAutoRegister = false;
+	Debug_DamageIndicator->bIsEditorOnly = true;
+#endif
 
 	MovePhase = EEnemyPhase::None;
 	AttackPhase = EAttackPhase::NotAttacking;
 	AttackTarget = nullptr;
 
-	UnstuckPlayerSightUpdate = 0.2f;
-	UnstuckAroundPlayerRadius = 1000.0f;
-	MaxAttempsToUnstuck = 10;
-
-	Debug_DamageIndicator = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Debug Damage Indicator"));
-	Debug_DamageIndicator->SetupAttachment(RootComponent);
-	Debug_DamageIndicator->SetRelativeLocation(FVector(0.0f, 0.0f, 100.0f));
-	Debug_DamageIndicator->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	Debug_DamageIndicator->SetGenerateOverlapEvents(false);
-	Debug_DamageIndicator->SetVisibility(false);
-
-	Debug_DamageIndicatorTime = 3.0f;
-
 	bDebug = false;
 
 	//SlowDebuffEffectWidget = CreateDefaultSubobject<UWidgetComponent>(TEXT("Slow Debuff Effect"));
@@ -94,29 +102,97 @@ ABase_NPC_SimpleChase::ABase_NPC_SimpleChase()
 	//DamageDebuffEffectWidget->SetVisibility(false);
 }
 
+// a blueprint saved before archetypes plays with the default tuning until it is migrated
+void ABase_NPC_SimpleChase::PostLoad()
+{
+	Super::PostLoad();
+#if WITH_EDITORONLY_DATA
+	if (HasAnyFlags(RF_ClassDefaultObject) && !Archetype && !MatchesLegacyTuning(GetDefault<UBase_EnemyArchetype>()))
+	{
+		UE_LOG(LogHypercube, Warning, TEXT("%s has tuning from before archetypes, run -run=Base_MigrateEnemyTuning"), *GetClass()->GetName());
+	}
+#endif
+}
+
+void ABase_NPC_SimpleChase::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+	const FAttackStats& Attack = GetArchetype()->SimpleAttack;
+	AttackCollision->SetRelativeLocation(FVector((Capsule->GetScaledCapsuleRadius() + Attack.AttackLength) / 2.0f, 0.0f, 20.0f));
+	AttackCollision->SetBoxExtent(FVector(Attack.AttackLength - Capsule->GetScaledCapsuleRadius(), Attack.AttackWidth, 32.0f));
+	SetDifficultyScale(1.0f, 1.0f);
+}
+
+#if WITH_EDITORONLY_DATA
+bool ABase_NPC_SimpleChase::MatchesLegacyTuning(const UBase_EnemyArchetype* Tuning) const
+{
+	return Tuning->JumpTime == JumpTime
+		&& Tuning->AggroRadius == AggroRadius
+		&& Tuning->AggroTime == AggroTime
+		&& FAttackStats::StaticStruct()->CompareScriptStruct(&Tuning->SimpleAttack, &SimpleAttack, PPF_None)
+		&& Tuning->UnstuckPlayerSightUpdate == UnstuckPlayerSightUpdate
+		&& Tuning->UnstuckAroundPlayerRadius == UnstuckAroundPlayerRadius
+		&& Tuning->MaxAttempsToUnstuck == MaxAttempsToUnstuck
+		&& Tuning->Debug_DamageIndicatorTime == Debug_DamageIndicatorTime;
+}
+#endif
+
 // Called when the game starts or when spawned
 void ABase_NPC_SimpleChase::BeginPlay()
 {
+	if (UBase_LevelSubsystem* LevelSubsystem = UBase_LevelSubsystem::Get(this))
+	{
+		LevelSubsystem->RegisterEnemy(this);
+	}
 	GetWorld()->GetTimerManager().SetTimer(DelayedInitTimerHandle, this, &ABase_NPC_SimpleChase::DelayedInit, DelayedInitTime, false);
 	Super::BeginPlay();
 }
 
+// The death path unregisters the enemy; this catches enemies that go away without dying, so the registry never keeps
+// a pointer to a destroyed actor. One destroyed mid-level (KillZ, DestroyActor) counts as removed like a kill,
+// on level teardown it is only dropped from the registry.
+void ABase_NPC_SimpleChase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (IsValid(LevelController) && LevelController->GetEnemyRegistry().IsValid(RegistryHandle))
+	{
+		if (EndPlayReason == EEndPlayReason::Destroyed)
+		{
+			LevelController->RemoveEnemy(this);
+		}
+		else
+		{
+			LevelController->GetEnemyRegistry().Remove(RegistryHandle);
+			RegistryHandle.Invalidate();
+		}
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
 void ABase_NPC_SimpleChase::DelayedInit()
 {
+	HYPERCUBE_ALLOC_SCOPE();
 	AttackTarget = Cast<AHypercubeCharacter>(UGameplayStatics::GetPlayerCharacter(GetWorld(), 0));
-	NoticeCollision->SetGenerateOverlapEvents(true);
 	TickSemaphore = 0;
 	SetActorTickEnabled(false);
+	NoticeCollision->SetGenerateOverlapEvents(true);
+}
 
-	if (!LevelController)
+FEnemyRegistry* ABase_NPC_SimpleChase::GetEnemyRegistry() const
+{
+	return LevelController ? &LevelController->GetEnemyRegistry() : nullptr;
+}
+
+void ABase_NPC_SimpleChase::SetMovePhase(EEnemyPhase Phase)
+{
+	if (Phase != MovePhase)
 	{
-		TArray<AActor*> FoundActors;
-		UGameplayStatics::GetAllActorsOfClass(GetWorld(), ABase_LevelController::StaticClass(), FoundActors);
-		if (FoundActors.Num())
-		{
-			LevelController = Cast<ABase_LevelController>(FoundActors[0]);
-			LevelController->AddEnemy(this);
-		}
+		FHypercubeTrace::EnemyPhase(this, uint8(MovePhase), uint8(Phase));
+		FHypercubeEventLog::Record(EHypercubeEvent::EnemyPhase, this, float(MovePhase), float(Phase));
+	}
+	MovePhase = Phase;
+	if (FEnemyRegistry* Registry = GetEnemyRegistry())
+	{
+		Registry->SetPhase(RegistryHandle, Phase);
 	}
 }
 
@@ -148,8 +224,20 @@ void ABase_NPC_SimpleChase::ForceTickDisable()
 	SetActorTickEnabled(false);
 }
 
+void ABase_NPC_SimpleChase::SetActorTickEnabled(bool bEnabled)
+{
+	Super::SetActorTickEnabled(bEnabled);
+	if (FEnemyRegistry* Registry = GetEnemyRegistry())
+	{
+		Registry->SetTicking(RegistryHandle, bEnabled);
+	}
+}
+
 void ABase_NPC_SimpleChase::Tick(float DeltaSeconds)
 {
+	SCOPE_CYCLE_COUNTER(STAT_Hypercube_EnemyTick);
+	GAMEPLAY_SYSTEM_SCOPE(Enemies);
+	HYPERCUBE_ALLOC_SCOPE();
 	if (AttackPhase != EAttackPhase::NotAttacking)
 	{
 		TickRotateToTarget(DeltaSeconds);
@@ -171,82 +259,70 @@ void ABase_NPC_SimpleChase::TickRotateToTarget(float DeltaSeconds)
 	FVector ToTarget = AttackTarget->GetActorLocation() - GetActorLocation();
 	ToTarget.Z = 0.0f;
 	ToTarget.Normalize();
-	SetActorRotation(UKismetMathLibrary::MakeRotFromXZ(FMath::Lerp(GetActorForwardVector(), ToTarget, DeltaSeconds * SimpleAttack.AttackRotationMultiplier), FVector::ZAxisVector));
+	SetActorRotation(UKismetMathLibrary::MakeRotFromXZ(FMath::Lerp(GetActorForwardVector(), ToTarget, DeltaSeconds * GetArchetype()->SimpleAttack.AttackRotationMultiplier), FVector::ZAxisVector));
 }
 
 void ABase_NPC_SimpleChase::TickMoveForward(float DeltaSeconds)
 {
-	AddActorWorldOffset(GetActorForwardVector() * SimpleAttack.AttackMoveForwardSpeed * DeltaSeconds, true);
+	AddActorWorldOffset(GetActorForwardVector() * GetArchetype()->SimpleAttack.AttackMoveForwardSpeed * DeltaSeconds, true);
 }
 
 void ABase_NPC_SimpleChase::CheckPlayerHit()
 {
-	TSet<AActor*> collisions;
-	AttackCollision->GetOverlappingActors(collisions, AHypercubeCharacter::StaticClass());
-	if (collisions.Num())
-	{
-		AttackTarget->TakeDamage(SimpleAttack.Damage);
-	}
-}
-
-void ABase_NPC_SimpleChase::ActivateDebugDamageIndicator()
-{
-	Debug_DamageIndicator->SetVisibility(true);
-	if (GetWorld()->GetTimerManager().IsTimerActive(Debug_DamageIndicatorTimerHandle))
+	SCOPE_CYCLE_COUNTER(STAT_Hypercube_CheckPlayerHit);
+	const bool bHit = AttackCollision->IsOverlappingActor(AttackTarget);
+	INC_DWORD_STAT(STAT_Hypercube_OverlapQueries);
+	++FGameplayFrameCounters::OverlapQueries;
+	INC_DWORD_STAT_BY(STAT_Hypercube_OverlappingActors, bHit ? 1 : 0);
+	if (bHit)
 	{
-		GetWorld()->GetTimerManager().ClearTimer(Debug_DamageIndicatorTimerHandle);
+		AttackTarget->TakeDamage(Overrides.Damage);
 	}
-	GetWorld()->GetTimerManager().SetTimer(Debug_DamageIndicatorTimerHandle, this, &ABase_NPC_SimpleChase::OnEndDebugDamageIndicatorTimer, Debug_DamageIndicatorTime, false);
-}
-
-void ABase_NPC_SimpleChase::OnEndDebugDamageIndicatorTimer()
-{
-	Debug_DamageIndicator->SetVisibility(false);
 }
 
 void ABase_NPC_SimpleChase::SetAttackCollision(bool Active)
 {
-	if (bDebug)
-	{
-		AttackCollision->SetVisibility(Active);
-	}
 	AttackCollision->SetActive(Active);
 }
 
 void ABase_NPC_SimpleChase::SetDebugAttackCollision(bool Active)
 {
-	if (bDebug)
+}
+
+void ABase_NPC_SimpleChase::TakeDamage(float Damage)
+{
+	if (ApplyDamage(Damage))
 	{
-		Debug_AttackCollision->SetVisibility(Active);
-		Debug_AttackCollision->SetActive(Active);
+		PlayDeath();
 	}
 }
 
-void ABase_NPC_SimpleChase::TakeDamage(float Damage)
+bool ABase_NPC_SimpleChase::ApplyDamage(float Damage)
 {
+	const bool bWasAlive = Health > 0.0f;
 	Health -= Damage;
-	if (bDebug)
+	FHypercubeTrace::Damage(this, Damage, Health);
+	FHypercubeEventLog::Record(EHypercubeEvent::EnemyDamaged, this, Damage, Health);
+	if (FEnemyRegistry* Registry = GetEnemyRegistry())
 	{
-		ActivateDebugDamageIndicator();
+		Registry->SetHealth(RegistryHandle, Health);
 	}
+	HYPERCUBE_DEBUG_DAMAGE(this, bDebug, GetArchetype()->Debug_DamageIndicatorTime);
 	EnemyActionDelegate.Broadcast(EEnemyAction::Damaged, true);
-	if (Health <= 0.0f)
-	{
-		PlayDeath();
-	}
+	return bWasAlive && Health <= 0.0f;
 }
 
 void ABase_NPC_SimpleChase::OnNotice()
 {
 	AttackTarget->OnEnemyAggro(this);
-	MovePhase = EEnemyPhase::Noticing;
+	SetMovePhase(EEnemyPhase::Noticing);
 	SetTickState(true);
-	GetWorld()->GetTimerManager().SetTimer(NoticeTimerHandle, this, &ABase_NPC_SimpleChase::AfterNotice, AggroTime, false);
+	GetWorld()->GetTimerManager().SetTimer(NoticeTimerHandle, this, &ABase_NPC_SimpleChase::AfterNotice, GetArchetype()->AggroTime, false);
 }
 
 void ABase_NPC_SimpleChase::AfterNotice()
 {
-	MovePhase = EEnemyPhase::Chasing;
+	SetMovePhase(EEnemyPhase::Chasing);
 	SetTickState(false);
 }
 
@@ -255,27 +331,31 @@ void ABase_NPC_SimpleChase::Attack()
 	switch (AttackPhase)
 	{
 	case EAttackPhase::NotAttacking:
-		UE_LOG(LogTemp, Warning, TEXT("Enemy Attacks!"));
+		FHypercubeEventLog::Record(EHypercubeEvent::EnemyAttack, this);
 		AttackPhase = EAttackPhase::Opener;
+		if (FEnemyRegistry* Registry = GetEnemyRegistry())
+		{
+			Registry->SetAttacking(RegistryHandle, true);
+		}
 		SetTickState(true);
-		SetDebugAttackCollision(true);
-		GetWorld()->GetTimerManager().SetTimer(AttackTimerHandle, this, &ABase_NPC_SimpleChase::Attack, SimpleAttack.OpenerTime, false);
+		GetWorld()->GetTimerManager().SetTimer(AttackTimerHandle, this, &ABase_NPC_SimpleChase::Attack, GetArchetype()->SimpleAttack.OpenerTime, false);
 		break;
 	case EAttackPhase::Opener:
 		AttackPhase = EAttackPhase::Attacking;
-		SetDebugAttackCollision(false);
 		SetAttackCollision(true);
-		GetWorld()->GetTimerManager().SetTimer(AttackTimerHandle, this, &ABase_NPC_SimpleChase::Attack, SimpleAttack.AttackTime, false);
+		GetWorld()->GetTimerManager().SetTimer(AttackTimerHandle, this, &ABase_NPC_SimpleChase::Attack, GetArchetype()->SimpleAttack.AttackTime, false);
 		break;
 	case EAttackPhase::Attacking:
 		AttackPhase = EAttackPhase::AfterAttack;
 		SetAttackCollision(false);
-		SetDebugAttackCollision(true);
-		GetWorld()->GetTimerManager().SetTimer(AttackTimerHandle, this, &ABase_NPC_SimpleChase::Attack, SimpleAttack.AfterAttackTime, false);
+		GetWorld()->GetTimerManager().SetTimer(AttackTimerHandle, this, &ABase_NPC_SimpleChase::Attack, GetArchetype()->SimpleAttack.AfterAttackTime, false);
 		break;
 	case EAttackPhase::AfterAttack:
 		AttackPhase = EAttackPhase::NotAttacking;
-		SetDebugAttackCollision(false);
+		if (FEnemyRegistry* Registry = GetEnemyRegistry())
+		{
+			Registry->SetAttacking(RegistryHandle, false);
+		}
 		SetTickState(false);
 		EnemyActionDelegate.Broadcast(EEnemyAction::AttackEnd, true);
 	}
@@ -283,23 +363,23 @@ void ABase_NPC_SimpleChase::Attack()
 
 void ABase_NPC_SimpleChase::JumpTo(FVector Destination)
 {
-	UE_LOG(LogTemp, Warning, TEXT("%f, %f, %f"), Destination.X, Destination.Y, Destination.Z);
+	FHypercubeEventLog::Record(EHypercubeEvent::EnemyJump, this, Destination.X, Destination.Y, Destination.Z);
+	const float Duration = GetArchetype()->JumpTime;
 	FVector NowPos = GetActorLocation();
 	FVector LookDestination = Destination - NowPos;
 	LookDestination.Z = 0.0f;
 	SetActorRotation(LookDestination.Rotation().Quaternion());
 	FVector Velocity;
-	Velocity.X = (Destination.X - NowPos.X) / JumpTime;
-	Velocity.Y = (Destination.Y - NowPos.Y) / JumpTime;
-	Velocity.Z = Destination.Z - NowPos.Z - 0.25f * JumpTime * JumpTime * MoveComp->GetGravityZ();
+	Velocity.X = (Destination.X - NowPos.X) / Duration;
+	Velocity.Y = (Destination.Y - NowPos.Y) / Duration;
+	Velocity.Z = Destination.Z - NowPos.Z - 0.25f * Duration * Duration * MoveComp->GetGravityZ();
 	LaunchCharacter(Velocity, true, true);
-	UE_LOG(LogTemp, Warning, TEXT("%f"), MoveComp->GetGravityZ());
-	GetWorld()->GetTimerManager().SetTimer(JumpTimerHandle, this, &ABase_NPC_SimpleChase::OnEndJump, JumpTime, false);
+	GetWorld()->GetTimerManager().SetTimer(JumpTimerHandle, this, &ABase_NPC_SimpleChase::OnEndJump, Duration, false);
 }
 
 void ABase_NPC_SimpleChase::OnEndJump()
 {
-	UE_LOG(LogTemp, Warning, TEXT("EndJump!"));
+	FHypercubeEventLog::Record(EHypercubeEvent::EnemyLanded, this);
 	EnemyActionDelegate.Broadcast(EEnemyAction::JumpEnd, true);
 }
 
@@ -309,6 +389,14 @@ void ABase_NPC_SimpleChase::PlayDeath()
 	EnemyDeathDelegate.Broadcast();
 }
 
+void ABase_NPC_SimpleChase::PlayEnemySound(EEnemySoundCategory Category, class USoundBase* Sound)
+{
+	if (LevelController)
+	{
+		LevelController->RequestEnemySound(Category, Sound, GetActorLocation());
+	}
+}
+
 class ABase_LevelController* ABase_NPC_SimpleChase::GetLevelController() const
 {
 	return LevelController;
@@ -319,6 +407,28 @@ class USphereComponent* ABase_NPC_SimpleChase::GetNoticeCollision() const
 	return NoticeCollision;
 }
 
+class UBoxComponent* ABase_NPC_SimpleChase::GetAttackCollision() const
+{
+	return AttackCollision;
+}
+
+UBase_EnemyArchetype* ABase_NPC_SimpleChase::GetArchetype() const
+{
+	if (Archetype)
+	{
+		return Archetype;
+	}
+	return GetMutableDefault<UBase_EnemyArchetype>();
+}
+
+void ABase_NPC_SimpleChase::SetDifficultyScale(float DamageScale, float AggroRadiusScale)
+{
+	const UBase_EnemyArchetype* Tuning = GetArchetype();
+	Overrides.Damage = Tuning->SimpleAttack.Damage * DamageScale;
+	Overrides.AggroRadius = Tuning->AggroRadius * AggroRadiusScale;
+	NoticeCollision->SetSphereRadius(Overrides.AggroRadius);
+}
+
 void ABase_NPC_SimpleChase::SetSlowDebuff(float Mult, float Time)
 {
 	if (GetWorld()->GetTimerManager().IsTimerActive(SlowDebuffTimerHandle))
@@ -353,9 +463,9 @@ void ABase_NPC_SimpleChase::SetDamageDebuff(float Mult, float Time)
 	}
 	else
 	{
-		BaseDamage = SimpleAttack.Damage;
+		BaseDamage = Overrides.Damage;
 
-		SimpleAttack.Damage *= Mult;
+		Overrides.Damage *= Mult;
 
 		//DamageDebuffEffectWidget->SetVisibility(true);
 
@@ -366,14 +476,15 @@ void ABase_NPC_SimpleChase::SetDamageDebuff(float Mult, float Time)
 
 void ABase_NPC_SimpleChase::OnEndDamageDebuff()
 {
-	SimpleAttack.Damage = BaseDamage;
+	Overrides.Damage = BaseDamage;
 	//DamageDebuffEffectWidget->SetVisibility(false);
 	EnemyActionDelegate.Broadcast(EEnemyAction::DamageDecreaseDebuffEnd, true);
 }
 
 bool ABase_NPC_SimpleChase::PlayerHasSightOn() const
 {
-	if (!AttackTarget->GetController()->LineOfSightTo(this))
+	SCOPE_CYCLE_COUNTER(STAT_Hypercube_PlayerHasSightOn);
+	if (!AttackTarget->GetController() || !AttackTarget->GetController()->LineOfSightTo(this))
 	{
 		return false;
 	}
@@ -382,25 +493,51 @@ bool ABase_NPC_SimpleChase::PlayerHasSightOn() const
 	{
 		return false;
 	}
+	if (!GEngine->GameViewport || !GEngine->GameViewport->Viewport)
+	{
+		return false; // -nullrhi runs have no viewport
+	}
 	const FVector2D ViewportSize = FVector2D(GEngine->GameViewport->Viewport->GetSizeXY());
 	return ScreenLocation.X > 0 && ScreenLocation.Y > 0 && ScreenLocation.X < ViewportSize.X && ScreenLocation.Y < ViewportSize.Y;
 }
 
 void ABase_NPC_SimpleChase::Unstuck()
 {
+	SCOPE_CYCLE_COUNTER(STAT_Hypercube_Unstuck);
+	GAMEPLAY_SYSTEM_SCOPE(Enemies);
+	HYPERCUBE_ALLOC_SCOPE();
 	if (PlayerHasSightOn())
 	{
-		GetWorld()->GetTimerManager().SetTimer(CheckPlayerSightTimerHandle, this, &ABase_NPC_SimpleChase::Unstuck, UnstuckPlayerSightUpdate, false);
+		GetWorld()->GetTimerManager().SetTimer(CheckPlayerSightTimerHandle, this, &ABase_NPC_SimpleChase::Unstuck, GetArchetype()->UnstuckPlayerSightUpdate, false);
 		return;
 	}
-	TArray<AActor*> FoundActors;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), ARecastNavMesh::StaticClass(), FoundActors);
-	class ARecastNavMesh* NavData = Cast<ARecastNavMesh>(FoundActors[0]);
+	UBase_LevelSubsystem* LevelSubsystem = UBase_LevelSubsystem::Get(this);
+	ANavigationData* NavData = LevelSubsystem ? LevelSubsystem->GetNavData() : nullptr;
+	if (!NavData)
+	{
+		EnemyActionDelegate.Broadcast(EEnemyAction::UnstuckEnd, false);
+		return;
+	}
+	// candidates come from the controller's stream so unstuck placement repeats in deterministic runs
+	TOptional<FRandomStream> LocalStream;
+	if (!LevelController)
+	{
+		LocalStream.Emplace(FMath::Rand());
+	}
+	FRandomStream& Stream = LevelController ? LevelController->GetUnstuckStream() : LocalStream.GetValue();
 	FNavLocation FindResult;
 	FVector PlayerLocation = AttackTarget->GetActorLocation();
-	for (int i = 0; i < MaxAttempsToUnstuck; ++i)
+	const float SearchRadius = GetArchetype()->UnstuckAroundPlayerRadius;
+	const FVector ProjectExtent(SearchRadius * 0.25f, SearchRadius * 0.25f, SearchRadius);
+	for (int i = 0; i < GetArchetype()->MaxAttempsToUnstuck; ++i)
 	{
-		if (NavData->GetRandomReachablePointInRadius(PlayerLocation, UnstuckAroundPlayerRadius, FindResult))
+		float Angle = Stream.FRandRange(0.0f, 2.0f * PI);
+		float Distance = FMath::Sqrt(Stream.GetFraction()) * SearchRadius;
+		FVector Candidate = PlayerLocation + FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f) * Distance;
+		const bool bProjected = NavData->ProjectPoint(Candidate, FindResult, ProjectExtent);
+		LevelSubsystem->NoteNavQueries(bProjected ? 2 : 1);
+		if (bProjected
+			&& NavData->TestPath(FPathFindingQuery(this, *NavData, FindResult.Location, PlayerLocation), EPathFindingMode::Hierarchical, nullptr))
 		{
 			SetActorLocation(FindResult.Location, false, nullptr, ETeleportType::ResetPhysics);
 			if (!PlayerHasSightOn())
@@ -411,4 +548,47 @@ void ABase_NPC_SimpleChase::Unstuck()
 		}
 	}
 	EnemyActionDelegate.Broadcast(EEnemyAction::UnstuckEnd, false);
-}
\ No newline at end of file
+}
+
+int ABase_NPC_SimpleChase::CountActiveTimers() const
+{
+	const FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+	const FTimerHandle* Handles[] = { &NoticeTimerHandle, &AttackTimerHandle, &DelayedInitTimerHandle, &JumpTimerHandle,
+		&SlowDebuffTimerHandle, &DamageDebuffTimerHandle, &CheckPlayerSightTimerHandle };
+	int Count = 0;
+	for (const FTimerHandle* Handle : Handles)
+	{
+		Count += TimerManager.IsTimerActive(*Handle) ? 1 : 0;
+	}
+	return Count;
+}
+
+EEnemyPhase ABase_NPC_SimpleChase::GetMovePhase() const
+{
+	return MovePhase;
+}
+
+bool ABase_NPC_SimpleChase::IsAttacking() const
+{
+	return AttackPhase != EAttackPhase::NotAttacking;
+}
+
+bool ABase_NPC_SimpleChase::HasAttackTarget() const
+{
+	return AttackTarget != nullptr;
+}
+
+EAttackPhase ABase_NPC_SimpleChase::GetAttackPhase() const
+{
+	return AttackPhase;
+}
+
+bool ABase_NPC_SimpleChase::IsTickRequested() const
+{
+	return TickSemaphore > 0;
+}
+
+bool ABase_NPC_SimpleChase::IsUnstuckPending() const
+{
+	return GetWorld()->GetTimerManager().IsTimerActive(CheckPlayerSightTimerHandle);
+}
@@ -2,36 +2,22 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "Base_EnemyRegistry.h"
+#include "Base_AudioBudgetComponent.h"
+#include "Base_EnemyArchetype.h"
 #include "Base_NPC_SimpleChase.generated.h"
 
+// the per-enemy part of the tuning, scaled by difficulty and debuffs; the rest is read from the archetype
 USTRUCT(BlueprintType)
-struct FAttackStats
+struct FEnemyOverrides
 {
 	GENERATED_BODY()
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	float Damage;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	float OpenerTime;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	float AttackTime;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	float AfterAttackTime;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	float AttackRotationMultiplier;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	float AttackMoveForwardSpeed;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	float AttackLength;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	float AttackWidth;
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float AggroRadius;
 };
 
 UENUM(BlueprintType)
@@ -84,10 +70,12 @@ class HYPERCUBE_API ABase_NPC_SimpleChase : public ACharacter
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Components, meta = (AllowPrivateAccess = "true"))
 	class UBoxComponent* AttackCollision;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Components, meta = (AllowPrivateAccess = "true"))
+	// Editor-only and never registered, kept so blueprints that still reference them load; null in cooked builds.
+	// Debug drawing is done by FGameplayDebugDraw
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Components, meta = (AllowPrivateAccess = "true", DeprecatedProperty, DeprecationMessage = "Debug drawing moved to the level subsystem, see hypercube.DebugDraw"))
 	class UBoxComponent* Debug_AttackCollision;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true", DeprecatedProperty, DeprecationMessage = "Debug drawing moved to the level subsystem, see hypercube.DebugDraw"))
 	class UStaticMeshComponent* Debug_DamageIndicator;
 
 	//UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
@@ -103,6 +91,8 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = LevelController)
 	class ABase_LevelController* LevelController;
 
+	FEnemyHandle RegistryHandle;
+
 	UPROPERTY(BlueprintAssignable, Category = EventDispatchers)
 	FOnEnemyDeath EnemyDeathDelegate;
 
@@ -115,33 +105,45 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats | Health")
 	float MaxHealth;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats | Jump")
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Stats")
+	class UBase_EnemyArchetype* Archetype;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Stats")
+	FEnemyOverrides Overrides;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Debug")
+	bool bDebug;
+
+#if WITH_EDITORONLY_DATA
+	// Tuning from before archetypes, kept only so Base_MigrateEnemyTuning can move it into archetype assets;
+	// nothing reads it at runtime. Delete it once the content is migrated.
+	UPROPERTY(VisibleAnywhere, Category = "Stats | Jump")
 	float JumpTime;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats | Aggro")
+	UPROPERTY(VisibleAnywhere, Category = "Stats | Aggro")
 	float AggroRadius;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats | Aggro")
+	UPROPERTY(VisibleAnywhere, Category = "Stats | Aggro")
 	float AggroTime;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats | Attack")
+	UPROPERTY(VisibleAnywhere, Category = "Stats | Attack")
 	FAttackStats SimpleAttack;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats | Unstuck")
+	UPROPERTY(VisibleAnywhere, Category = "Stats | Unstuck")
 	float UnstuckPlayerSightUpdate;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats | Unstuck")
+	UPROPERTY(VisibleAnywhere, Category = "Stats | Unstuck")
 	float UnstuckAroundPlayerRadius;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats | Unstuck")
+	UPROPERTY(VisibleAnywhere, Category = "Stats | Unstuck")
 	int MaxAttempsToUnstuck;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Debug")
-	bool bDebug;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Debug")
+	UPROPERTY(VisibleAnywhere, Category = "Debug")
 	float Debug_DamageIndicatorTime;
 
+	bool MatchesLegacyTuning(const class UBase_EnemyArchetype* Tuning) const;
+#endif
+
 protected:
 
 	uint8 TickSemaphore;
@@ -160,17 +162,16 @@ protected:
 	void SetTickState(bool Activate);
 	void ForceTickDisable();
 
+	virtual void PostLoad() override;
+	virtual void PostInitializeComponents() override;
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void Tick(float DeltaSeconds) override;
 
 	void TickRotateToTarget(float DeltaSeconds);
 	void TickMoveForward(float DeltaSeconds);
 	void CheckPlayerHit();
 
-	FTimerHandle Debug_DamageIndicatorTimerHandle;
-	void ActivateDebugDamageIndicator();
-	void OnEndDebugDamageIndicatorTimer();
-
 	FTimerHandle JumpTimerHandle;
 	void OnEndJump();
 
@@ -184,17 +185,24 @@ protected:
 
 	FTimerHandle CheckPlayerSightTimerHandle;
 
+	FEnemyRegistry* GetEnemyRegistry() const;
+	void SetMovePhase(EEnemyPhase Phase);
+
 public:	
 
 	UFUNCTION(BlueprintCallable)
 	void SetAttackCollision(bool Active);
 
-	UFUNCTION(BlueprintCallable)
+	// does nothing, attack volumes are drawn from the attack phase
+	UFUNCTION(BlueprintCallable, meta = (DeprecatedFunction, DeprecationMessage = "Debug drawing moved to the level subsystem, see hypercube.DebugDraw"))
 	void SetDebugAttackCollision(bool Active);
 
 	UFUNCTION(BlueprintCallable)
 	void TakeDamage(float Damage);
 
+	// TakeDamage without the death, returns true when this damage killed the enemy; the caller handles the death
+	bool ApplyDamage(float Damage);
+
 	UFUNCTION(BlueprintCallable)
 	void OnNotice();
 
@@ -210,12 +218,25 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void PlayDeath();
 
+	UFUNCTION(BlueprintCallable)
+	void PlayEnemySound(EEnemySoundCategory Category, class USoundBase* Sound);
+
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	class ABase_LevelController* GetLevelController() const;
 
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	class USphereComponent* GetNoticeCollision() const;
 
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	class UBoxComponent* GetAttackCollision() const;
+
+	// falls back to the class defaults of UBase_EnemyArchetype
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	class UBase_EnemyArchetype* GetArchetype() const;
+
+	// rebuilds the overrides from the archetype, so applying it twice does not compound
+	void SetDifficultyScale(float DamageScale, float AggroRadiusScale);
+
 	UFUNCTION(BlueprintCallable)
 	void SetSlowDebuff(float Mult, float Time);
 
@@ -227,4 +248,15 @@ public:
 
 	UFUNCTION(BlueprintCallable)
 	void Unstuck();
+
+	int CountActiveTimers() const; // for stat Hypercube
+
+	virtual void SetActorTickEnabled(bool bEnabled) override; // mirrored into the registry
+
+	EEnemyPhase GetMovePhase() const;
+	bool IsAttacking() const;
+	EAttackPhase GetAttackPhase() const;
+	bool IsTickRequested() const; // TickSemaphore > 0
+	bool IsUnstuckPending() const; // waiting for the player to look away
+	bool HasAttackTarget() const; // false until DelayedInit found the player
 };
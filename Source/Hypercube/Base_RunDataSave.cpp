@@ -1,6 +1,61 @@
 #include "Base_RunDataSave.h"
+#include "Hypercube.h"
 
 void FLevelData::Log()
 {
-	UE_LOG(LogTemp, Warning, TEXT("PlayerWon: %d, Score: %f, Killed: %f, MaxMult: %f, MultOnDeath: %f"), int(PlayerWon), Score, EnemiesPercentageKilled, MaxMultiplicator, OnDeathMultiplicator);
-}
\ No newline at end of file
+	UE_LOG(LogHypercube, Warning, TEXT("PlayerWon: %d, Score: %f, Killed: %f, MaxMult: %f, MultOnDeath: %f"), int(PlayerWon), Score, EnemiesPercentageKilled, MaxMultiplicator, OnDeathMultiplicator);
+}
+
+FLevelRollingStats::FLevelRollingStats()
+{
+	Runs = Wins = 0;
+	AvgWinRate = AvgScore = AvgPlayTime = AvgOnDeathEnemyChasing = AvgDifficultyParameter = 0.0f;
+}
+
+void FLevelRollingStats::Add(const FLevelData& Data, float Weight)
+{
+	float Alpha = Runs ? Weight : 1.0f;
+	++Runs;
+	Wins += Data.PlayerWon ? 1 : 0;
+	AvgWinRate = FMath::Lerp(AvgWinRate, Data.PlayerWon ? 1.0f : 0.0f, Alpha);
+	AvgScore = FMath::Lerp(AvgScore, Data.Score, Alpha);
+	AvgPlayTime = FMath::Lerp(AvgPlayTime, Data.PlayTime, Alpha);
+	AvgOnDeathEnemyChasing = FMath::Lerp(AvgOnDeathEnemyChasing, float(Data.OnDeathEnemyChasing), Alpha);
+	AvgDifficultyParameter = FMath::Lerp(AvgDifficultyParameter, Data.DifficultyParameter, Alpha);
+}
+
+FRunAggregates::FRunAggregates()
+{
+	Reset();
+}
+
+void FRunAggregates::Add(const FLevelData& Data, float Weight)
+{
+	++TotalRuns;
+	DeathStreak = Data.PlayerWon ? 0 : DeathStreak + 1;
+	LastRun = Data;
+	if (Data.LevelIndex >= 0)
+	{
+		if (PerLevel.Num() <= Data.LevelIndex)
+		{
+			PerLevel.SetNum(Data.LevelIndex + 1);
+		}
+		PerLevel[Data.LevelIndex].Add(Data, Weight);
+	}
+}
+
+void FRunAggregates::Rebuild(const TArray<FLevelData>& LevelData, float Weight)
+{
+	Reset();
+	for (const FLevelData& Data : LevelData)
+	{
+		Add(Data, Weight);
+	}
+}
+
+void FRunAggregates::Reset()
+{
+	TotalRuns = DeathStreak = 0;
+	LastRun = FLevelData();
+	PerLevel.Empty();
+}
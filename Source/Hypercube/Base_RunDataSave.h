@@ -44,6 +44,63 @@ struct FLevelData
 	void Log();
 };
 
+USTRUCT(BlueprintType)
+struct FLevelRollingStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int Runs;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int Wins;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float AvgWinRate;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float AvgScore;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float AvgPlayTime;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float AvgOnDeathEnemyChasing;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float AvgDifficultyParameter;
+
+	FLevelRollingStats();
+
+	void Add(const FLevelData& Data, float Weight); // exponential moving averages, Weight is the share of the newest run
+};
+
+// Running aggregates over the whole run history, maintained on every save so that
+// the adaptive difficulty never has to walk the history. New inputs go into Add.
+USTRUCT(BlueprintType)
+struct FRunAggregates
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int TotalRuns;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int DeathStreak;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FLevelData LastRun;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TArray<FLevelRollingStats> PerLevel;
+
+	FRunAggregates();
+
+	void Add(const FLevelData& Data, float Weight);
+	void Rebuild(const TArray<FLevelData>& LevelData, float Weight);
+	void Reset();
+};
+
 UCLASS()
 class HYPERCUBE_API UBase_RunDataSave : public USaveGame
 {
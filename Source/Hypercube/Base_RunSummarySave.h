@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/SaveGame.h"
+#include "Base_RunDataSave.h"
+#include "Base_Scoreboard.h"
+#include "Base_RunSummarySave.generated.h"
+
+// Small companion of UBase_RunDataSave that is loaded on level start instead of the full history
+UCLASS()
+class HYPERCUBE_API UBase_RunSummarySave : public USaveGame
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(EditAnywhere)
+	FRunAggregates Aggregates;
+
+	UPROPERTY(EditAnywhere)
+	TArray<FScoreboardData> Scoreboard;
+
+};
@@ -0,0 +1,432 @@
+#include "Base_ScalingBenchmarkComponent.h"
+#include "Base_LevelController.h"
+#include "Base_NPC_SimpleChase.h"
+#include "HypercubeCharacter.h"
+#include "HypercubeAllocTracker.h"
+#include "Base_LevelSubsystem.h"
+#include "NavigationData.h"
+#include "Engine/World.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformMemory.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "Hypercube.h"
+
+UBase_ScalingBenchmarkComponent::UBase_ScalingBenchmarkComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	Tiers = { 100, 500, 1000, 2000 };
+	SpawnRadius = 3000.0f;
+	SettleTime = 3.0f;
+	SampleFrames = 600;
+	RegressionTolerance = 0.15f;
+
+	Player = nullptr;
+	Stage = EStage::Finished;
+	TierIndex = 0;
+	SettleTimer = 0.0f;
+	LastFrameTime = 0.0;
+	WorldTickStart = 0.0;
+	WorldTickTotal = 0.0;
+	GameplayAllocs = 0;
+	bStartedByTest = false;
+}
+
+bool UBase_ScalingBenchmarkComponent::bTestRequested = false;
+TOptional<bool> UBase_ScalingBenchmarkComponent::TestResult;
+
+bool UBase_ScalingBenchmarkComponent::IsRequested()
+{
+	return bTestRequested || FParse::Param(FCommandLine::Get(), TEXT("HypercubeScalingBenchmark"));
+}
+
+void UBase_ScalingBenchmarkComponent::RequestFromTest()
+{
+	bTestRequested = true;
+	TestResult.Reset();
+}
+
+void UBase_ScalingBenchmarkComponent::CancelTestRequest()
+{
+	bTestRequested = false;
+}
+
+bool UBase_ScalingBenchmarkComponent::GetTestResult(bool& bOutPassed)
+{
+	bOutPassed = TestResult.Get(false);
+	return TestResult.IsSet();
+}
+
+// the enemy class is resolved on the first tick, after the level controller collected its spawn enemy classes
+void UBase_ScalingBenchmarkComponent::Start(class AHypercubeCharacter* NewPlayer)
+{
+	if (Stage != EStage::Finished || Results.Num())
+	{
+		return;
+	}
+	Player = NewPlayer;
+	Player->bDebug_Invincible = true;
+	bStartedByTest = bTestRequested;
+	bTestRequested = false;
+	TierIndex = 0;
+	Stage = EStage::Spawning;
+	SetComponentTickEnabled(true);
+}
+
+void UBase_ScalingBenchmarkComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	switch (Stage)
+	{
+	case EStage::Spawning:
+		if (!EnemyClass)
+		{
+			EnemyClass = Cast<ABase_LevelController>(GetOwner())->GetBenchmarkEnemyClass();
+			if (!EnemyClass)
+			{
+				UE_LOG(LogHypercube, Error, TEXT("Scaling benchmark has no enemy class, set BenchmarkEnemyClass or -HypercubeScalingEnemy="));
+				Stage = EStage::Finished;
+				Report(false);
+				break;
+			}
+			UE_LOG(LogHypercube, Warning, TEXT("Scaling benchmark started with %s"), *EnemyClass->GetName());
+			DespawnLevelEnemies();
+			WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UBase_ScalingBenchmarkComponent::OnWorldTickStart);
+			WorldTickEndHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UBase_ScalingBenchmarkComponent::OnWorldTickEnd);
+		}
+		SpawnTier();
+		SettleTimer = SettleTime;
+		Stage = EStage::Settling;
+		break;
+	case EStage::Settling:
+		ForceCombat();
+		SettleTimer -= DeltaTime;
+		if (SettleTimer <= 0.0f)
+		{
+			FrameTimes.Reset(SampleFrames);
+			LastFrameTime = 0.0;
+			WorldTickTotal = 0.0;
+			GameplayAllocs = 0;
+			Stage = EStage::Measuring;
+		}
+		break;
+	case EStage::Measuring:
+	{
+		ForceCombat();
+		double Now = FPlatformTime::Seconds();
+		if (LastFrameTime > 0.0)
+		{
+			FrameTimes.Add(float((Now - LastFrameTime) * 1000.0));
+		}
+		LastFrameTime = Now;
+#if HYPERCUBE_ALLOC_TRACKING
+		GameplayAllocs += FHypercubeAllocTracker::GetLastFrameAllocs();
+#endif
+		if (FrameTimes.Num() >= SampleFrames)
+		{
+			FinishTier();
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+// enemies placed in the map would chase in every tier; they leave the registry first, so removing them
+// is not counted as kills and does not end the level
+void UBase_ScalingBenchmarkComponent::DespawnLevelEnemies()
+{
+	FEnemyRegistry& Registry = Cast<ABase_LevelController>(GetOwner())->GetEnemyRegistry();
+	const TArray<ABase_NPC_SimpleChase*> LevelEnemies = Registry.GetAllEnemies();
+	for (ABase_NPC_SimpleChase* Enemy : LevelEnemies)
+	{
+		Registry.Remove(Enemy->RegistryHandle);
+		Enemy->RegistryHandle.Invalidate();
+		Enemy->Destroy();
+	}
+	UE_LOG(LogHypercube, Warning, TEXT("Scaling benchmark removed %d enemies placed in the level"), LevelEnemies.Num());
+}
+
+// candidates come from the level's spawn stream, so every run of the same seed gets the same layout
+void UBase_ScalingBenchmarkComponent::SpawnTier()
+{
+	ABase_LevelController* LevelController = Cast<ABase_LevelController>(GetOwner());
+	UBase_LevelSubsystem* LevelSubsystem = UBase_LevelSubsystem::Get(this);
+	ANavigationData* NavData = LevelSubsystem ? LevelSubsystem->GetNavData() : nullptr;
+	FRandomStream& Stream = LevelController->GetSpawnStream();
+	const FVector Origin = Player->GetActorLocation();
+	const FVector ProjectExtent(SpawnRadius * 0.1f, SpawnRadius * 0.1f, SpawnRadius);
+	const float MinDistance = FMath::Min(500.0f, SpawnRadius);
+	const int32 Wanted = Tiers[TierIndex];
+	int32 Attempts = Wanted * 2;
+	while (Enemies.Num() < Wanted && Attempts-- > 0)
+	{
+		float Angle = Stream.FRandRange(0.0f, 2.0f * PI);
+		float Distance = FMath::Lerp(MinDistance, SpawnRadius, FMath::Sqrt(Stream.GetFraction()));
+		FVector Candidate = Origin + FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f) * Distance;
+		FNavLocation Location(Candidate);
+		if (NavData && !NavData->ProjectPoint(Candidate, Location, ProjectExtent))
+		{
+			continue;
+		}
+		FVector SpawnLocation = Location.Location + FVector(0.0f, 0.0f, 100.0f);
+		FRotator Rotation = (Origin - SpawnLocation).GetSafeNormal2D().Rotation();
+		if (ABase_NPC_SimpleChase* Enemy = LevelController->SpawnEnemyAt(EnemyClass, SpawnLocation, Rotation))
+		{
+			Enemies.Add(Enemy);
+		}
+	}
+	UE_LOG(LogHypercube, Warning, TEXT("Scaling benchmark tier %d: %d of %d enemies spawned"), TierIndex, Enemies.Num(), Wanted);
+}
+
+// enemies chase through their behavior once noticed; attacks are restarted as soon as one ends
+void UBase_ScalingBenchmarkComponent::ForceCombat()
+{
+	for (ABase_NPC_SimpleChase* Enemy : Enemies)
+	{
+		if (!IsValid(Enemy) || !Enemy->HasAttackTarget())
+		{
+			continue;
+		}
+		if (Enemy->GetMovePhase() == EEnemyPhase::None)
+		{
+			Enemy->OnNotice();
+		}
+		else if (Enemy->GetMovePhase() == EEnemyPhase::Chasing && !Enemy->IsAttacking())
+		{
+			Enemy->Attack();
+		}
+	}
+}
+
+void UBase_ScalingBenchmarkComponent::FinishTier()
+{
+	TArray<float> Sorted = FrameTimes;
+	Sorted.Sort();
+	auto Percentile = [&Sorted](float P)
+	{
+		return Sorted[FMath::Clamp(FMath::CeilToInt(P * Sorted.Num()) - 1, 0, Sorted.Num() - 1)];
+	};
+	FScalingTierResult Result;
+	Result.Requested = Tiers[TierIndex];
+	Result.Spawned = Enemies.Num();
+	Result.Frames = Sorted.Num();
+	Result.GameThreadMs = float(WorldTickTotal * 1000.0 / FMath::Max(Sorted.Num(), 1));
+	Result.FrameMsP50 = Percentile(0.5f);
+	Result.FrameMsP95 = Percentile(0.95f);
+	Result.FrameMsP99 = Percentile(0.99f);
+	Result.FrameMsMax = Sorted.Last();
+	Result.UsedPhysicalMB = float(double(FPlatformMemory::GetStats().UsedPhysical) / (1024.0 * 1024.0));
+	Result.GameplayAllocs = -1;
+#if HYPERCUBE_ALLOC_TRACKING
+	Result.GameplayAllocs = FHypercubeAllocTracker::IsInstalled() ? GameplayAllocs : -1;
+#endif
+	Results.Add(Result);
+	UE_LOG(LogHypercube, Warning, TEXT("Scaling benchmark %d enemies: game thread %.2f ms, frame p50 %.2f p95 %.2f p99 %.2f max %.2f ms, %.0f MB"),
+		Result.Spawned, Result.GameThreadMs, Result.FrameMsP50, Result.FrameMsP95, Result.FrameMsP99, Result.FrameMsMax, Result.UsedPhysicalMB);
+
+	++TierIndex;
+	Stage = Tiers.IsValidIndex(TierIndex) ? EStage::Spawning : EStage::Finished;
+	if (Stage == EStage::Finished)
+	{
+		Finish();
+	}
+}
+
+void UBase_ScalingBenchmarkComponent::Finish()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+	FWorldDelegates::OnWorldPostActorTick.Remove(WorldTickEndHandle);
+
+	const FString ResultsPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / TEXT("EnemyScaling.json");
+	FFileHelper::SaveStringToFile(ResultsToJson(), *ResultsPath);
+	UE_LOG(LogHypercube, Warning, TEXT("Scaling benchmark results written to %s"), *ResultsPath);
+
+	FString BaselinePath = FPaths::ProjectDir() / TEXT("Benchmarks") / TEXT("EnemyScalingBaseline.json");
+	FParse::Value(FCommandLine::Get(), TEXT("HypercubeScalingBaseline="), BaselinePath);
+	bool bPassed = true;
+	if (FParse::Param(FCommandLine::Get(), TEXT("HypercubeScalingUpdateBaseline")))
+	{
+		bPassed = FFileHelper::SaveStringToFile(ResultsToJson(), *BaselinePath);
+		UE_LOG(LogHypercube, Warning, TEXT("Scaling baseline %s %s"), bPassed ? TEXT("written to") : TEXT("could not be written to"), *BaselinePath);
+	}
+	else
+	{
+		bPassed = CompareWithBaseline(BaselinePath);
+	}
+	bool bAllocTracking = false;
+#if HYPERCUBE_ALLOC_TRACKING
+	bAllocTracking = FHypercubeAllocTracker::IsInstalled();
+#endif
+	if (!bAllocTracking)
+	{
+		UE_LOG(LogHypercube, Error, TEXT("Scaling benchmark ran without allocation tracking, add -HypercubeAllocTracking (not available in Shipping)"));
+		bPassed = false;
+	}
+	for (const FScalingTierResult& Result : Results)
+	{
+		if (Result.GameplayAllocs > 0)
+		{
+			UE_LOG(LogHypercube, Error, TEXT("Gameplay hot paths allocated %d times over %d frames at %d enemies"), Result.GameplayAllocs, Result.Frames, Result.Requested);
+			bPassed = false;
+		}
+	}
+	Report(bPassed);
+}
+
+void UBase_ScalingBenchmarkComponent::Report(bool bPassed)
+{
+	SetComponentTickEnabled(false);
+	if (bStartedByTest)
+	{
+		TestResult = bPassed;
+		return;
+	}
+	FPlatformMisc::RequestExitWithStatus(false, bPassed ? 0 : 1);
+}
+
+void UBase_ScalingBenchmarkComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+	FWorldDelegates::OnWorldPostActorTick.Remove(WorldTickEndHandle);
+	Super::EndPlay(EndPlayReason);
+}
+
+void UBase_ScalingBenchmarkComponent::OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld())
+	{
+		WorldTickStart = FPlatformTime::Seconds();
+	}
+}
+
+void UBase_ScalingBenchmarkComponent::OnWorldTickEnd(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld() && Stage == EStage::Measuring && WorldTickStart > 0.0)
+	{
+		WorldTickTotal += FPlatformTime::Seconds() - WorldTickStart;
+	}
+}
+
+FString UBase_ScalingBenchmarkComponent::ResultsToJson() const
+{
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("map"), GetWorld()->GetMapName());
+	Root->SetStringField(TEXT("enemyClass"), EnemyClass->GetName());
+	Root->SetStringField(TEXT("cpu"), FPlatformMisc::GetCPUBrand().TrimStartAndEnd());
+	TArray<TSharedPtr<FJsonValue>> TierValues;
+	for (const FScalingTierResult& Result : Results)
+	{
+		TSharedRef<FJsonObject> Tier = MakeShared<FJsonObject>();
+		Tier->SetNumberField(TEXT("requested"), Result.Requested);
+		Tier->SetNumberField(TEXT("spawned"), Result.Spawned);
+		Tier->SetNumberField(TEXT("frames"), Result.Frames);
+		Tier->SetNumberField(TEXT("gameThreadMs"), Result.GameThreadMs);
+		Tier->SetNumberField(TEXT("frameMsP50"), Result.FrameMsP50);
+		Tier->SetNumberField(TEXT("frameMsP95"), Result.FrameMsP95);
+		Tier->SetNumberField(TEXT("frameMsP99"), Result.FrameMsP99);
+		Tier->SetNumberField(TEXT("frameMsMax"), Result.FrameMsMax);
+		Tier->SetNumberField(TEXT("usedPhysicalMB"), Result.UsedPhysicalMB);
+		Tier->SetNumberField(TEXT("gameplayAllocs"), Result.GameplayAllocs);
+		TierValues.Add(MakeShared<FJsonValueObject>(Tier));
+	}
+	Root->SetArrayField(TEXT("tiers"), TierValues);
+
+	FString Json;
+	FJsonSerializer::Serialize(Root, TJsonWriterFactory<>::Create(&Json));
+	return Json;
+}
+
+// game thread time and p95 frame time are compared per tier; memory is only reported
+bool UBase_ScalingBenchmarkComponent::CompareWithBaseline(const FString& BaselinePath) const
+{
+	FString BaselineText;
+	if (!FFileHelper::LoadFileToString(BaselineText, *BaselinePath))
+	{
+		UE_LOG(LogHypercube, Error, TEXT("No scaling baseline at %s, the run can not pass without one (-HypercubeScalingUpdateBaseline writes it)"), *BaselinePath);
+		return false;
+	}
+	TSharedPtr<FJsonObject> Baseline;
+	const TArray<TSharedPtr<FJsonValue>>* BaselineTiers = nullptr;
+	if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineText), Baseline) || !Baseline.IsValid()
+		|| !Baseline->TryGetArrayField(TEXT("tiers"), BaselineTiers))
+	{
+		UE_LOG(LogHypercube, Error, TEXT("Scaling baseline %s can not be read"), *BaselinePath);
+		return false;
+	}
+	bool bPassed = true;
+	for (const FScalingTierResult& Result : Results)
+	{
+		for (const TSharedPtr<FJsonValue>& Value : *BaselineTiers)
+		{
+			TSharedPtr<FJsonObject> Tier = Value->AsObject();
+			if (!Tier.IsValid() || int32(Tier->GetNumberField(TEXT("requested"))) != Result.Requested)
+			{
+				continue;
+			}
+			const float Limit = 1.0f + RegressionTolerance;
+			const float BaseGameThread = float(Tier->GetNumberField(TEXT("gameThreadMs")));
+			const float BaseP95 = float(Tier->GetNumberField(TEXT("frameMsP95")));
+			if (Result.GameThreadMs > BaseGameThread * Limit || Result.FrameMsP95 > BaseP95 * Limit)
+			{
+				UE_LOG(LogHypercube, Error, TEXT("Scaling regression at %d enemies: game thread %.2f ms (baseline %.2f), p95 %.2f ms (baseline %.2f)"),
+					Result.Requested, Result.GameThreadMs, BaseGameThread, Result.FrameMsP95, BaseP95);
+				bPassed = false;
+			}
+		}
+	}
+	UE_LOG(LogHypercube, Warning, TEXT("Scaling benchmark %s against %s"), bPassed ? TEXT("passed") : TEXT("failed"), *BaselinePath);
+	return bPassed;
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Tests/AutomationCommon.h"
+
+DEFINE_LATENT_AUTOMATION_COMMAND_TWO_PARAMETER(FWaitForScalingBenchmark, FAutomationTestBase*, Test, double, Deadline);
+
+// a map without a level controller or player never starts the benchmark, the deadline fails the test instead of hanging
+bool FWaitForScalingBenchmark::Update()
+{
+	bool bPassed = false;
+	if (!UBase_ScalingBenchmarkComponent::GetTestResult(bPassed))
+	{
+		if (FPlatformTime::Seconds() < Deadline)
+		{
+			return false;
+		}
+		UBase_ScalingBenchmarkComponent::CancelTestRequest();
+		Test->AddError(TEXT("Scaling benchmark did not finish in time, check that the map has a level controller and a player"));
+		return true;
+	}
+	Test->TestTrue(TEXT("Enemy scaling within the baseline"), bPassed);
+	return true;
+}
+
+// runs in a game client, e.g. -game -nullrhi -HypercubeAllocTracking -ExecCmds="Automation RunTests Hypercube.Performance.EnemyScaling"
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHypercubeEnemyScalingTest, "Hypercube.Performance.EnemyScaling",
+	EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FHypercubeEnemyScalingTest::RunTest(const FString& Parameters)
+{
+	// the level's own enemies are removed and its spawning is disabled while the benchmark runs
+	FString MapPath = TEXT("/Game/ThirdPersonCPP/Maps/levels/levels/training");
+	FParse::Value(FCommandLine::Get(), TEXT("HypercubeScalingMap="), MapPath);
+	float TimeoutSeconds = 600.0f;
+	FParse::Value(FCommandLine::Get(), TEXT("HypercubeScalingTimeout="), TimeoutSeconds);
+	UBase_ScalingBenchmarkComponent::RequestFromTest();
+	AutomationOpenMap(MapPath);
+	ADD_LATENT_AUTOMATION_COMMAND(FWaitForScalingBenchmark(this, FPlatformTime::Seconds() + TimeoutSeconds));
+	return true;
+}
+
+#endif
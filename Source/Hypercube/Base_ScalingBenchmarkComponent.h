@@ -0,0 +1,122 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Misc/Optional.h"
+#include "Base_ScalingBenchmarkComponent.generated.h"
+
+struct FScalingTierResult
+{
+	int32 Requested;
+	int32 Spawned;
+	int32 Frames;
+	float GameThreadMs; // mean world tick time
+	float FrameMsP50;
+	float FrameMsP95;
+	float FrameMsP99;
+	float FrameMsMax;
+	float UsedPhysicalMB;
+	int32 GameplayAllocs; // -1 without -HypercubeAllocTracking, which fails the run
+};
+
+// Measures how the game scales with the enemy count, started by the level controller with -HypercubeScalingBenchmark
+// (with -nullrhi for headless runs). The level spawns none of its own enemies and the ones placed in the map are removed,
+// so any map with a level controller works. For every tier it spawns enemies around the player through the level
+// controller, forces all of them to notice, chase and attack the invincible player, lets them settle and then samples
+// game thread time, frame-time percentiles and memory.
+// Results go to Saved/Benchmarks/EnemyScaling.json and are compared with Benchmarks/EnemyScalingBaseline.json
+// (-HypercubeScalingBaseline=<file> to use another one); a missing baseline fails the run. The baseline is a measured run:
+// regenerate it on the reference machine with a Development build and
+//   Hypercube.exe -game -nullrhi -HypercubeScalingBenchmark -HypercubeAllocTracking -HypercubeScalingUpdateBaseline
+// which writes the results over the baseline instead of comparing, then commit the file. Started from the command line
+// the process exits with 1 when a tier regressed; the automation test Hypercube.Performance.EnemyScaling runs the same
+// benchmark on -HypercubeScalingMap=<map> (the training map by default) and reports the result instead.
+// The run needs -HypercubeAllocTracking and fails without it; a tier also fails when the gameplay hot paths allocated while
+// it was measured.
+UCLASS()
+class HYPERCUBE_API UBase_ScalingBenchmarkComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UBase_ScalingBenchmarkComponent();
+
+	static bool IsRequested();
+
+	// for the automation test: the next level controller starts the benchmark, and the result is kept instead of exiting
+	static void RequestFromTest();
+	static void CancelTestRequest(); // the test gave up, a level loaded later must not start the benchmark
+	static bool GetTestResult(bool& bOutPassed); // false while the benchmark is still running
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Benchmark)
+	TArray<int32> Tiers;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Benchmark)
+	float SpawnRadius;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Benchmark)
+	float SettleTime;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Benchmark)
+	int32 SampleFrames;
+
+	// allowed slowdown against the baseline before a tier counts as a regression
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Benchmark)
+	float RegressionTolerance;
+
+	void Start(class AHypercubeCharacter* Player);
+
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+protected:
+
+	enum class EStage : uint8
+	{
+		Spawning,
+		Settling,
+		Measuring,
+		Finished
+	};
+
+	UPROPERTY()
+	class AHypercubeCharacter* Player;
+
+	TSubclassOf<class ABase_NPC_SimpleChase> EnemyClass;
+
+	EStage Stage;
+	int32 TierIndex;
+	float SettleTimer;
+	UPROPERTY()
+	TArray<class ABase_NPC_SimpleChase*> Enemies;
+	TArray<FScalingTierResult> Results;
+
+	TArray<float> FrameTimes; // ms
+	double LastFrameTime;
+	double WorldTickStart;
+	double WorldTickTotal;
+	int32 GameplayAllocs;
+	bool bStartedByTest;
+
+	static bool bTestRequested;
+	static TOptional<bool> TestResult;
+
+	FDelegateHandle WorldTickStartHandle;
+	FDelegateHandle WorldTickEndHandle;
+
+	void DespawnLevelEnemies();
+	void SpawnTier();
+	void ForceCombat();
+	void FinishTier();
+	void Finish();
+	void Report(bool bPassed); // exits the process, or keeps the result for the automation test
+
+	void OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void OnWorldTickEnd(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	FString ResultsToJson() const;
+	bool CompareWithBaseline(const FString& BaselinePath) const; // returns false on a regression
+};
@@ -0,0 +1,133 @@
+#include "Base_Scoreboard.h"
+#include "Base_LevelController.h"
+
+bool FScoreboardData::operator<(const FScoreboardData& Other) const
+{
+	return Score > Other.Score;
+}
+
+static bool ScoreboardHeapPredicate(const FScoreboardData& A, const FScoreboardData& B)
+{
+	return A.Score < B.Score;
+}
+
+FScoreboardIndex::FScoreboardIndex()
+{
+	Version = 0;
+	Reset(10);
+}
+
+void FScoreboardIndex::Reset(int InCapacity)
+{
+	Capacity = InCapacity > 0 ? InCapacity : 1;
+	Heap.Reset(Capacity);
+	++Version;
+	CachedVersion = Version - 1;
+	CachedNum = -1;
+}
+
+void FScoreboardIndex::Build(const TArray<FLevelData>& LevelData, int InCapacity)
+{
+	Reset(InCapacity);
+	for (int i = 0; i < LevelData.Num(); ++i)
+	{
+		if (LevelData[i].Score > 0.0f)
+		{
+			Add({ LevelData[i].Score, LevelData[i].DifficultyParameter, LevelData[i].LevelIndex });
+		}
+	}
+}
+
+void FScoreboardIndex::Restore(const TArray<FScoreboardData>& Entries, int InCapacity)
+{
+	Reset(InCapacity);
+	for (const FScoreboardData& Data : Entries)
+	{
+		Add(Data);
+	}
+}
+
+bool FScoreboardIndex::Add(const FScoreboardData& Data)
+{
+	if (Heap.Num() >= Capacity)
+	{
+		if (Data.Score <= Heap.HeapTop().Score)
+		{
+			return false;
+		}
+		Heap.HeapPopDiscard(ScoreboardHeapPredicate, false);
+	}
+	Heap.HeapPush(Data, ScoreboardHeapPredicate);
+	++Version;
+	return true;
+}
+
+int FScoreboardIndex::Num() const
+{
+	return Heap.Num();
+}
+
+const TArray<FScoreboardData>& FScoreboardIndex::GetEntries() const
+{
+	return Heap;
+}
+
+const FScoreboardView& FScoreboardIndex::GetView(int Num, const TArray<FString>& LevelNamesToShow)
+{
+	Num = FMath::Clamp(Num, 0, Heap.Num());
+	if (CachedVersion != Version || CachedNum != Num || CachedLevelNames != LevelNamesToShow)
+	{
+		RebuildView(Num, LevelNamesToShow);
+		CachedVersion = Version;
+		CachedNum = Num;
+		CachedLevelNames = LevelNamesToShow;
+	}
+	return CachedView;
+}
+
+void FScoreboardIndex::RebuildView(int Num, const TArray<FString>& LevelNamesToShow)
+{
+	TArray<FScoreboardData> Sorted = Heap;
+	Sorted.Sort();
+
+	CachedView.Rows.Reset(Num);
+	CachedView.Table = Num ? FString("Scoreboard:\n\n      Level        Difficulty    Score\n") : FString("");
+	CachedView.Places.Reset();
+	CachedView.Levels = FString("Level\n\n");
+	CachedView.Scores = FString("Score\n\n");
+	CachedView.Diffs = FString("Difficulty\n\n");
+	for (int i = 0; i < Num; ++i)
+	{
+		const FScoreboardData& Data = Sorted[i];
+		FScoreboardRow& Row = CachedView.Rows.AddDefaulted_GetRef();
+		Row.Place = i + 1;
+		Row.Level = (Data.LevelIndex >= 0 && Data.LevelIndex < LevelNamesToShow.Num()) ? LevelNamesToShow[Data.LevelIndex] : FString("????");
+		Row.Difficulty = FloatToFString(Data.DifficultyParameter);
+		Row.Score.AppendInt(FMath::RoundToInt(Data.Score));
+
+		CachedView.Table.AppendInt(Row.Place);
+		CachedView.Table += (Row.Place < 10) ? FString(".  ") : FString(". ");
+		CachedView.Table += Row.Level;
+		for (int j = 0; j < 12 - Row.Level.Len(); ++j)
+		{
+			CachedView.Table.AppendChar(' ');
+		}
+		CachedView.Table += Row.Difficulty;
+		int SpaceCount = Row.Difficulty.Len() < 3 ? 20 : 13;
+		for (int j = 0; j < SpaceCount; ++j)
+		{
+			CachedView.Table.AppendChar(' ');
+		}
+		CachedView.Table += Row.Score;
+		CachedView.Table.AppendChar('\n');
+
+		CachedView.Places.AppendInt(Row.Place);
+		CachedView.Places.AppendChar('\n');
+		CachedView.Levels += Row.Level;
+		CachedView.Levels.AppendChar('\n');
+		CachedView.Scores += Row.Score;
+		CachedView.Scores.AppendChar('\n');
+		CachedView.Diffs += Row.Difficulty;
+		CachedView.Diffs.AppendChar('\n');
+	}
+}
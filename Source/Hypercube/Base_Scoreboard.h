@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Base_RunDataSave.h"
+#include "Base_Scoreboard.generated.h"
+
+USTRUCT(BlueprintType)
+struct FScoreboardData
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Score;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float DifficultyParameter;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int LevelIndex;
+
+	bool operator<(const FScoreboardData& Other) const;
+};
+
+USTRUCT(BlueprintType)
+struct FScoreboardRow
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int Place;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FString Level;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FString Difficulty;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FString Score;
+};
+
+USTRUCT(BlueprintType)
+struct FScoreboardView
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	TArray<FScoreboardRow> Rows;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FString Table;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FString Places;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FString Levels;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FString Scores;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FString Diffs;
+};
+
+// Bounded top-K of winning scores, kept as a min-heap so that a new record only costs O(log K).
+// Formatted rows are rebuilt lazily: every mutation bumps Version, and a view is reused only for the same version,
+// row count and level names.
+struct FScoreboardIndex
+{
+	FScoreboardIndex();
+
+	void Reset(int InCapacity);
+	void Build(const TArray<FLevelData>& LevelData, int InCapacity);
+	void Restore(const TArray<FScoreboardData>& Entries, int InCapacity);
+	bool Add(const FScoreboardData& Data); // returns true when the top-K changed
+
+	int Num() const;
+	const TArray<FScoreboardData>& GetEntries() const; // unordered
+	const FScoreboardView& GetView(int Num, const TArray<FString>& LevelNamesToShow);
+
+protected:
+
+	int Capacity;
+	TArray<FScoreboardData> Heap; // root is the lowest score still on the board
+
+	uint32 Version;
+	uint32 CachedVersion;
+	int CachedNum;
+	TArray<FString> CachedLevelNames;
+	FScoreboardView CachedView;
+
+	void RebuildView(int Num, const TArray<FString>& LevelNamesToShow);
+};
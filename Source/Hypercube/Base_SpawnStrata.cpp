@@ -0,0 +1,123 @@
+#include "Base_SpawnStrata.h"
+#include "Base_EnemySpawnSet.h"
+
+FSpawnStrata::FSpawnStrata()
+{
+}
+
+void FSpawnStrata::Build(const TArray<FEnemySpawnRecord>& Records, float CellSize)
+{
+	Reset();
+	const float InvCellSize = 1.0f / FMath::Max(CellSize, 1.0f);
+
+	// counting sort by cell: one pass to size the strata, one to fill them
+	TMap<FIntPoint, int32> CellToStratum;
+	TArray<int32> RecordStratum;
+	RecordStratum.SetNumUninitialized(Records.Num());
+	for (int i = 0; i < Records.Num(); ++i)
+	{
+		FIntPoint Cell(FMath::FloorToInt(Records[i].Location.X * InvCellSize), FMath::FloorToInt(Records[i].Location.Y * InvCellSize));
+		int32* Found = CellToStratum.Find(Cell);
+		int32 Stratum = Found ? *Found : CellToStratum.Add(Cell, Strata.Add({ 0, 0 }));
+		++Strata[Stratum].Num;
+		RecordStratum[i] = Stratum;
+	}
+	int32 Start = 0;
+	for (FStratum& Stratum : Strata)
+	{
+		Stratum.Start = Start;
+		Start += Stratum.Num;
+		Stratum.Num = 0;
+	}
+	Order.SetNumUninitialized(Records.Num());
+	for (int i = 0; i < Records.Num(); ++i)
+	{
+		FStratum& Stratum = Strata[RecordStratum[i]];
+		Order[Stratum.Start + Stratum.Num++] = i;
+	}
+	Quotas.SetNumZeroed(Strata.Num());
+}
+
+void FSpawnStrata::Reset()
+{
+	Order.Reset();
+	Strata.Reset();
+	Quotas.Reset();
+}
+
+void FSpawnStrata::Select(int Count, FRandomStream& Stream, int MaxPerStratum, TArray<int32>& OutIndices)
+{
+	const int Total = Order.Num();
+	Count = FMath::Min(Count, GetCapacity(MaxPerStratum));
+	if (Count <= 0)
+	{
+		return;
+	}
+
+	// systematic allocation: quotas are proportional to stratum size, sum to Count exactly,
+	// and the random offset decides which strata get the rounded-up share
+	const double Step = double(Count) / double(Total);
+	const double Offset = Stream.GetFraction();
+	int32 Cumulative = 0;
+	int Assigned = 0;
+	for (int s = 0; s < Strata.Num(); ++s)
+	{
+		int32 Begin = FMath::FloorToInt(Cumulative * Step + Offset);
+		Cumulative += Strata[s].Num;
+		int32 End = FMath::FloorToInt(Cumulative * Step + Offset);
+		Quotas[s] = FMath::Min(End - Begin, Strata[s].Num);
+		if (MaxPerStratum > 0)
+		{
+			Quotas[s] = FMath::Min(Quotas[s], MaxPerStratum);
+		}
+		Assigned += Quotas[s];
+	}
+
+	// whatever the cap cut off goes to strata with room left, starting from a random one
+	const int FirstStratum = Stream.RandRange(0, Strata.Num() - 1);
+	for (int i = 0; i < Strata.Num() && Assigned < Count; ++i)
+	{
+		int s = (FirstStratum + i) % Strata.Num();
+		int Room = MaxPerStratum > 0 ? FMath::Min(MaxPerStratum, Strata[s].Num) : Strata[s].Num;
+		int Extra = FMath::Min(Room - Quotas[s], Count - Assigned);
+		Quotas[s] += Extra;
+		Assigned += Extra;
+	}
+
+	// partial Fisher-Yates inside each stratum
+	OutIndices.Reserve(OutIndices.Num() + Count);
+	for (int s = 0; s < Strata.Num(); ++s)
+	{
+		const FStratum& Stratum = Strata[s];
+		for (int i = 0; i < Quotas[s]; ++i)
+		{
+			int32 Pick = Stream.RandRange(Stratum.Start + i, Stratum.Start + Stratum.Num - 1);
+			Order.Swap(Stratum.Start + i, Pick);
+			OutIndices.Add(Order[Stratum.Start + i]);
+		}
+	}
+}
+
+int FSpawnStrata::Num() const
+{
+	return Order.Num();
+}
+
+int FSpawnStrata::NumStrata() const
+{
+	return Strata.Num();
+}
+
+int FSpawnStrata::GetCapacity(int MaxPerStratum) const
+{
+	if (MaxPerStratum <= 0)
+	{
+		return Order.Num();
+	}
+	int Capacity = 0;
+	for (const FStratum& Stratum : Strata)
+	{
+		Capacity += FMath::Min(Stratum.Num, MaxPerStratum);
+	}
+	return Capacity;
+}
@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FEnemySpawnRecord;
+
+// Spawn records grouped into square XY cells, built once per level.
+// Select draws a subset whose per-cell counts follow the cell sizes, so enemies keep the level's density
+// instead of clustering where a plain shuffle happens to pick many neighbours.
+class HYPERCUBE_API FSpawnStrata
+{
+public:
+
+	FSpawnStrata();
+
+	void Build(const TArray<FEnemySpawnRecord>& Records, float CellSize);
+	void Reset();
+
+	// appends up to Count record indices; MaxPerStratum <= 0 means no cap. O(strata + Count)
+	void Select(int Count, FRandomStream& Stream, int MaxPerStratum, TArray<int32>& OutIndices);
+
+	int Num() const; // number of records
+	int NumStrata() const;
+	int GetCapacity(int MaxPerStratum) const; // most records Select can return with this cap
+
+protected:
+
+	struct FStratum
+	{
+		int32 Start;
+		int32 Num;
+	};
+
+	TArray<int32> Order; // record indices grouped by stratum
+	TArray<FStratum> Strata;
+	TArray<int32> Quotas;
+};
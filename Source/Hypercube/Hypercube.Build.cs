@@ -8,6 +8,12 @@ public class Hypercube : ModuleRules
 	{
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
-		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "UMG", "NavigationSystem" });	
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "UMG", "Slate", "SlateCore", "NavigationSystem", "Json", "HypercubeAllocHook" });	
+
+		if (Target.bBuildEditor)
+		{
+			// Base_MigrateEnemyTuningCommandlet
+			PrivateDependencyModuleNames.Add("AssetRegistry");
+		}
 	}
 }
@@ -2,6 +2,23 @@
 
 #include "Hypercube.h"
 #include "Modules/ModuleManager.h"
+#include "HypercubeEventLog.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, Hypercube, "Hypercube" );
- 
\ No newline at end of file
+DEFINE_LOG_CATEGORY(LogHypercube);
+
+class FHypercubeModule : public FDefaultGameModuleImpl
+{
+public:
+
+	virtual void StartupModule() override
+	{
+		FHypercubeEventLog::Startup();
+	}
+
+	virtual void ShutdownModule() override
+	{
+		FHypercubeEventLog::Shutdown();
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FHypercubeModule, Hypercube, "Hypercube" );
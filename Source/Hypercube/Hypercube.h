@@ -3,3 +3,10 @@
 #pragma once
 
 #include "CoreMinimal.h"
+
+// compiled out of Shipping, per-event diagnostics go to FHypercubeEventLog instead
+#if UE_BUILD_SHIPPING
+DECLARE_LOG_CATEGORY_EXTERN(LogHypercube, Log, NoLogging);
+#else
+DECLARE_LOG_CATEGORY_EXTERN(LogHypercube, Log, All);
+#endif
@@ -10,12 +10,21 @@
 #include "Kismet/KismetMathLibrary.h"
 #include "Math/UnrealMathUtility.h"
 #include "Components/BoxComponent.h"
-#include "Base_NPC_SimpleChase.h"
 #include "Components/StaticMeshComponent.h"
+#include "Base_NPC_SimpleChase.h"
 #include "Base_LevelController.h"
+#include "Base_LevelSubsystem.h"
+#include "Base_InputRecorderComponent.h"
+#include "Base_HudModel.h"
 #include "Kismet/GameplayStatics.h"
 #include "GameFramework/PlayerController.h"
 #include "Components/WidgetComponent.h"
+#include "Engine/World.h"
+#include "HypercubeStats.h"
+#include "HypercubeAllocTracker.h"
+#include "HypercubeEventLog.h"
+#include "Base_GameplayDebugDraw.h"
+#include "Hypercube.h"
 
 //////////////////////////////////////////////////////////////////////////
 // AHypercubeCharacter
@@ -23,6 +32,7 @@
 AHypercubeCharacter::AHypercubeCharacter()
 {
 	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 	Capsule = GetCapsuleComponent();
 	Capsule->InitCapsuleSize(42.0f, 96.0f);
@@ -38,6 +48,8 @@ AHypercubeCharacter::AHypercubeCharacter()
 
 	// Configure character movement
 	MoveComp = GetCharacterMovement();
+	InputRecorder = nullptr;
+	LastMoveForward = LastMoveRight = 0.0f;
 	MoveComp->bOrientRotationToMovement = true; // Character moves in the direction of input...	
 	MoveComp->RotationRate = FRotator(0.0f, 540.0f, 0.0f); // ...at this rotation rate
 	MoveComp->JumpZVelocity = 600.0f;
@@ -64,22 +76,26 @@ AHypercubeCharacter::AHypercubeCharacter()
 	InvincAfterDamage = 1.0f;
 	Vampirism = 0.0f;
 	bIsInvincible = false;
+	bDebug_Invincible = false;
 
 	DashDistance = 700.0f;
 	DashTime = DashTimer = 0.2f;
+	DashPath = FVector::ZeroVector;
 	DashMoveControlTime = 0.1f;
-	DashCooldownTime = DashCooldownTimer = 1.5f;
+	DashCooldownTime = 1.5f;
+	DashReadyTime = 0.0f;
 
 	Score = 0.0f;
 	BaseScoreForEnemy = 10.0f;
 
 	DamageMultiplierEnemyCost = 0.5f;
-	EnemyChasing.Empty();
 	DamageMultiplier = TargetDamageMultiplier = 1.0f;
 	DamageMultiplierStaysTime = 5.0f;
 	DamageMultiplierDecreaseSpeed = 1.0f;
 	bDamageMultiplierStays = false;
 	bDamageMultiplierFalling = false;
+	DamageMultiplierFallStart = 0.0f;
+	DamageMultiplierFallFrom = 1.0f;
 
 	SimpleAttack = { 25.0f, 0.1f, 0.2f, 0.1f, 150.0f, 90.0f, 68.0f };
 
@@ -91,20 +107,19 @@ AHypercubeCharacter::AHypercubeCharacter()
 	AttackCollision->SetHiddenInGame(false);
 	AttackCollision->SetVisibility(false);
 
+	Debug_AttackCollision = nullptr;
+	Debug_DamageIndicator = nullptr;
+#if WITH_EDITORONLY_DATA
 	Debug_AttackCollision = CreateDefaultSubobject<UBoxComponent>(TEXT("Debug Attack Collision"));
 	Debug_AttackCollision->SetupAttachment(RootComponent);
-	Debug_AttackCollision->SetRelativeLocation(FVector(SimpleAttack.AttackRadius / 2.0f + GetCapsuleComponent()->GetUnscaledCapsuleRadius() / 2.0f, 0.0f, 20.0f));
-	Debug_AttackCollision->SetBoxExtent(FVector(SimpleAttack.AttackRadius - GetCapsuleComponent()->GetUnscaledCapsuleRadius(), SimpleAttack.AttackRadius * FMath::Tan(SimpleAttack.AttackAngle * PI / 360.0f), 32.0f));
-	Debug_AttackCollision->SetGenerateOverlapEvents(true);
-	Debug_AttackCollision->SetHiddenInGame(false);
-	Debug_AttackCollision->SetVisibility(false);
+	Debug_AttackCollision->bAutoRegister = false;
+	Debug_AttackCollision->bIsEditorOnly = true;
 
 	Debug_DamageIndicator = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Debug Damage Indicator"));
 	Debug_DamageIndicator->SetupAttachment(RootComponent);
-	Debug_DamageIndicator->SetRelativeLocation(FVector(0.0f, 0.0f, 100.0f));
-	Debug_DamageIndicator->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	Debug_DamageIndicator->SetGenerateOverlapEvents(false);
-	Debug_DamageIndicator->SetVisibility(false);
+	Debug_DamageIndicator->bAutoRegister = false;
+	Debug_DamageIndicator->bIsEditorOnly = true;
+#endif
 
 	Debug_DamageIndicatorTime = 3.0f;
 
@@ -112,13 +127,13 @@ AHypercubeCharacter::AHypercubeCharacter()
 
 	bIsGamePaused = false;
 
-	DamageFXAlpha = 0.0f;
+	HudModel = CreateDefaultSubobject<UBase_HudModel>(TEXT("HUD Model"));
 	DamageFXTime = 0.5f;
-	DamageFXTimer = 0.0f;
 
 	bDebug = false;
 
-	TargetCameraFov = FollowCamera->FieldOfView;
+	TargetCameraFov = CameraFovFrom = FollowCamera->FieldOfView;
+	CameraFovChangeStart = 0.0f;
 	CameraFovChangeSpeed = 10.0f;
 
 	SpeedBuffEffectWidget = CreateDefaultSubobject<UWidgetComponent>(TEXT("Speed Buff Effect"));
@@ -126,24 +141,22 @@ AHypercubeCharacter::AHypercubeCharacter()
 	SpeedBuffEffectWidget->SetRelativeLocation(FVector(0.0f, 0.0f, -Capsule->GetScaledCapsuleHalfHeight()));
 	SpeedBuffEffectWidget->SetVisibility(false);
 
-	DashBarPercentage = 1.0f;
 }
 
 void AHypercubeCharacter::BeginPlay()
 {
-	TArray<AActor*> FoundActors;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), ABase_LevelController::StaticClass(), FoundActors);
-	if (FoundActors.Num())
+	UBase_LevelSubsystem* LevelSubsystem = UBase_LevelSubsystem::Get(this);
+	LevelController = LevelSubsystem ? LevelSubsystem->GetLevelController() : nullptr;
+	if (LevelController)
 	{
-		LevelController = Cast<ABase_LevelController>(FoundActors[0]);
 		LevelController->SetPlayerCharacter(this);
 	}
-	else
-	{
-		LevelController = nullptr;
-	}
 	PlayerController = GetWorld()->GetFirstPlayerController();
 	Super::BeginPlay();
+	HudModel->SetValue(EHudValue::MaxHealth, MaxHealth);
+	HudModel->SetValue(EHudValue::Health, Health);
+	HudModel->SetValue(EHudValue::Score, Score);
+	HudModel->SetValue(EHudValue::DamageMultiplier, DamageMultiplier);
 	//GetWorld()->GetTimerManager().SetTimer(DelayedInitTimerHandle, this, &AHypercubeCharacter::DelayedInit, DelayedInitTime, false);
 }
 
@@ -167,12 +180,12 @@ void AHypercubeCharacter::SetupPlayerInputComponent(class UInputComponent* Playe
 	InputComp = PlayerInputComponent;
 	// Set up gameplay key bindings
 	check(PlayerInputComponent);
-	PlayerInputComponent->BindAction("Jump", IE_Pressed, this, &ACharacter::Jump);
-	PlayerInputComponent->BindAction("Jump", IE_Released, this, &ACharacter::StopJumping);
+	PlayerInputComponent->BindAction("Jump", IE_Pressed, this, &AHypercubeCharacter::OnJumpPressed);
+	PlayerInputComponent->BindAction("Jump", IE_Released, this, &AHypercubeCharacter::OnJumpReleased);
 
-	PlayerInputComponent->BindAction("Dash", IE_Pressed, this, &AHypercubeCharacter::Dash);
+	PlayerInputComponent->BindAction("Dash", IE_Pressed, this, &AHypercubeCharacter::OnDashPressed);
 
-	PlayerInputComponent->BindAction("Attack", IE_Pressed, this, &AHypercubeCharacter::ReceiveAttackInput);
+	PlayerInputComponent->BindAction("Attack", IE_Pressed, this, &AHypercubeCharacter::OnAttackPressed);
 
 	PlayerInputComponent->BindAction("Pause", IE_Pressed, this, &AHypercubeCharacter::Pause).bExecuteWhenPaused = true;
 
@@ -182,63 +195,124 @@ void AHypercubeCharacter::SetupPlayerInputComponent(class UInputComponent* Playe
 	// We have 2 versions of the rotation bindings to handle different kinds of devices differently
 	// "turn" handles devices that provide an absolute delta, such as a mouse.
 	// "turnrate" is for devices that we choose to treat as a rate of change, such as an analog joystick
-	PlayerInputComponent->BindAxis("Turn", this, &APawn::AddControllerYawInput);
-	PlayerInputComponent->BindAxis("LookUp", this, &APawn::AddControllerPitchInput);
+	PlayerInputComponent->BindAxis("Turn", this, &AHypercubeCharacter::Turn);
+	PlayerInputComponent->BindAxis("LookUp", this, &AHypercubeCharacter::LookUp);
 }
 
-void AHypercubeCharacter::Tick(float DeltaSeconds)
+// input handlers go through the recorder so a recorded run can be replayed with ApplyReplayInput
+void AHypercubeCharacter::Turn(float Value)
 {
-	if (MovementPhase == EPlayerMovementPhase::Dashing)
+	if (InputRecorder)
 	{
-		DashTick(DeltaSeconds);
+		InputRecorder->RecordAxis(EReplayAxis::Turn, Value);
 	}
-	else if (DashCooldownTimer < DashCooldownTime)
+	AddControllerYawInput(Value);
+}
+
+void AHypercubeCharacter::LookUp(float Value)
+{
+	if (InputRecorder)
 	{
-		DashCooldownTimer += DeltaSeconds;
-		DashBarPercentage = DashCooldownTimer / DashCooldownTime - 0.1f;
-		if (DashCooldownTimer >= DashCooldownTime)
-		{
-			OnEndDashCooldown();
-		}
+		InputRecorder->RecordAxis(EReplayAxis::LookUp, Value);
 	}
-	if (AttackPhase == EPlayerAttackPhase::Attacking)
+	AddControllerPitchInput(Value);
+}
+
+void AHypercubeCharacter::OnJumpPressed()
+{
+	if (InputRecorder)
 	{
-		AttackTick();
+		InputRecorder->RecordAction(EReplayAction::JumpPressed);
 	}
-	if (bDamageMultiplierFalling && DamageMultiplier > TargetDamageMultiplier)
+	Jump();
+}
+
+void AHypercubeCharacter::OnJumpReleased()
+{
+	if (InputRecorder)
 	{
-		DamageMultiplier -= DamageMultiplierDecreaseSpeed * DeltaSeconds;
-		if (DamageMultiplier < TargetDamageMultiplier)
-		{
-			DamageMultiplier = TargetDamageMultiplier;
-			bDamageMultiplierFalling = false;
-		}
+		InputRecorder->RecordAction(EReplayAction::JumpReleased);
 	}
-	if (DamageFXTimer > 0.0f)
+	StopJumping();
+}
+
+void AHypercubeCharacter::OnDashPressed()
+{
+	if (InputRecorder)
 	{
-		DamageFXAlpha = DamageFXCurve(1.0f - DamageFXTimer / DamageFXTime);
-		DamageFXTimer -= DeltaSeconds;
-		if (DamageFXTimer <= 0.0f)
-		{
-			DamageFXAlpha = 0.0f;
-		}
+		InputRecorder->RecordAction(EReplayAction::Dash);
 	}
-	if (FollowCamera->FieldOfView != TargetCameraFov)
+	Dash();
+}
+
+void AHypercubeCharacter::OnAttackPressed()
+{
+	if (InputRecorder)
 	{
-		FollowCamera->FieldOfView = FMath::Lerp(FollowCamera->FieldOfView, TargetCameraFov, CameraFovChangeSpeed * DeltaSeconds);
-		if (FMath::IsNearlyEqual(FollowCamera->FieldOfView, TargetCameraFov, 0.001f))
-		{
-			FollowCamera->FieldOfView = TargetCameraFov;
-		}
+		InputRecorder->RecordAction(EReplayAction::Attack);
 	}
+	ReceiveAttackInput();
+}
+
+void AHypercubeCharacter::SetInputRecorder(class UBase_InputRecorderComponent* Recorder)
+{
+	InputRecorder = Recorder;
+}
+
+// same order as the input stack: actions first, then axes
+void AHypercubeCharacter::ApplyReplayInput(const struct FInputFrame& Frame)
+{
+	if (Frame.Actions & uint8(EReplayAction::JumpPressed))
+	{
+		Jump();
+	}
+	if (Frame.Actions & uint8(EReplayAction::JumpReleased))
+	{
+		StopJumping();
+	}
+	if (Frame.Actions & uint8(EReplayAction::Dash))
+	{
+		Dash();
+	}
+	if (Frame.Actions & uint8(EReplayAction::Attack))
+	{
+		ReceiveAttackInput();
+	}
+	MoveForward(Frame.Axes[int(EReplayAxis::MoveForward)]);
+	MoveRight(Frame.Axes[int(EReplayAxis::MoveRight)]);
+	AddControllerYawInput(Frame.Axes[int(EReplayAxis::Turn)]);
+	AddControllerPitchInput(Frame.Axes[int(EReplayAxis::LookUp)]);
+}
+
+void AHypercubeCharacter::Tick(float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_Hypercube_PlayerTick);
+	GAMEPLAY_SYSTEM_SCOPE(Player);
+	HYPERCUBE_ALLOC_SCOPE();
+	if (MovementPhase == EPlayerMovementPhase::Dashing)
+	{
+		DashTick(DeltaSeconds);
+	}
+	if (AttackPhase == EPlayerAttackPhase::Attacking)
+	{
+		AttackTick();
+	}
+	ResolveDamage();
 	Super::Tick(DeltaSeconds);
 }
 
+void AHypercubeCharacter::UpdateTickEnabled()
+{
+	SetActorTickEnabled(MovementPhase == EPlayerMovementPhase::Dashing || AttackPhase == EPlayerAttackPhase::Attacking);
+}
+
+// the position is a function of the dash time, so the path is the same at any frame rate. The path was swept
+// at dash start and pawns are ignored while dashing, so the per-frame move doesn't sweep
 void AHypercubeCharacter::DashTick(float DeltaSeconds)
 {
-	AddActorWorldOffset(DashDestination * (DashDistance / DashTime) * DashVelocityCurve(DashTimer / DashTime) * DeltaSeconds, true);
-	DashTimer += DeltaSeconds;
-	DashBarPercentage = 1.0f - DashTimer / DashTime;
+	const float Covered = DashDistanceCurve(DashTimer / DashTime);
+	DashTimer = FMath::Min(DashTimer + DeltaSeconds, DashTime);
+	AddActorWorldOffset(DashPath * (DashDistanceCurve(DashTimer / DashTime) - Covered), false);
 	if (bDashMovementBlocked && DashTime - DashTimer <= DashMoveControlTime)
 	{
 		AllowMovingWhileDash();
@@ -251,22 +325,56 @@ void AHypercubeCharacter::DashTick(float DeltaSeconds)
 
 void AHypercubeCharacter::AttackTick()
 {
-	TSet<AActor*> collisions;
-	AttackCollision->GetOverlappingActors(collisions, ABase_NPC_SimpleChase::StaticClass());
-	for (auto it = collisions.begin(); it != collisions.end(); ++it)
+	SCOPE_CYCLE_COUNTER(STAT_Hypercube_AttackTick);
+	HYPERCUBE_ALLOC_SCOPE();
+	// hits are only queued here, a killed enemy would change the overlap list
+	const float Damage = SimpleAttack.Damage * GetDamageMultiplier();
+	int HitCount = 0;
+	for (const FOverlapInfo& Overlap : AttackCollision->GetOverlapInfos())
+	{
+		ABase_NPC_SimpleChase* Enemy = Cast<ABase_NPC_SimpleChase>(Overlap.OverlapInfo.GetActor());
+		bool bAlreadyHit = true;
+		if (IsValid(Enemy))
+		{
+			AttackEnemiesCollided.Add(Enemy, &bAlreadyHit);
+		}
+		if (!bAlreadyHit)
+		{
+			DamageQueue.Add(Enemy, Damage);
+			++HitCount;
+		}
+	}
+	INC_DWORD_STAT(STAT_Hypercube_OverlapQueries);
+	++FGameplayFrameCounters::OverlapQueries;
+	INC_DWORD_STAT_BY(STAT_Hypercube_OverlappingActors, HitCount);
+}
+
+void AHypercubeCharacter::ResolveDamage()
+{
+	if (DamageQueue.IsEmpty())
 	{
-		ABase_NPC_SimpleChase* tmp = Cast<ABase_NPC_SimpleChase>(*it);
-		if (tmp && !AttackEnemiesCollided.Contains(tmp))
+		return;
+	}
+	SCOPE_CYCLE_COUNTER(STAT_Hypercube_ResolveDamage);
+	FDamageQueue::FKilledEnemies Killed;
+	DamageQueue.Resolve(Killed);
+	if (Killed.Num())
+	{
+		OnEnemiesDeath(Killed);
+		for (ABase_NPC_SimpleChase* Enemy : Killed)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("Enemy damaged!"));
-			tmp->TakeDamage(SimpleAttack.Damage * DamageMultiplier);
-			AttackEnemiesCollided.Add(tmp);
+			Enemy->EnemyDeathDelegate.Broadcast();
 		}
 	}
 }
 
 void AHypercubeCharacter::MoveForward(float Value)
 {
+	LastMoveForward = Value;
+	if (InputRecorder)
+	{
+		InputRecorder->RecordAxis(EReplayAxis::MoveForward, Value);
+	}
 	if ((Controller != nullptr) && (Value != 0.0f))
 	{
 		// find out which way is forward
@@ -281,6 +389,11 @@ void AHypercubeCharacter::MoveForward(float Value)
 
 void AHypercubeCharacter::MoveRight(float Value)
 {
+	LastMoveRight = Value;
+	if (InputRecorder)
+	{
+		InputRecorder->RecordAxis(EReplayAxis::MoveRight, Value);
+	}
 	if ((Controller != nullptr) && (Value != 0.0f))
 	{
 		// find out which way is right
@@ -294,14 +407,12 @@ void AHypercubeCharacter::MoveRight(float Value)
 	}
 }
 
-float AHypercubeCharacter::DashVelocityCurve(float x) // f(x) where int_0^1(f(x))dx = 1
+float AHypercubeCharacter::DashDistanceCurve(float x)
 {
-	return (x >= 0.0f && x <= 1.0f) ? (PI / 2.0f) * FMath::Sin(PI * x) : 0.0f;
-	//return (x < 0.5f ? 4.0f * x : 4.0f - 4.0f * x);
-	//return 1.0;
+	return (1.0f - FMath::Cos(PI * FMath::Clamp(x, 0.0f, 1.0f))) / 2.0f;
 }
 
-inline float AHypercubeCharacter::DamageFXCurve(float x)
+float AHypercubeCharacter::DamageFXCurve(float x)
 {
 	if (x >= 0.0f && x <= 1.0f)
 	{
@@ -318,34 +429,43 @@ inline float AHypercubeCharacter::DamageFXCurve(float x)
 	return 0.0f;
 }
 
+bool AHypercubeCharacter::CanDash() const
+{
+	return bCanDash && MovementPhase == EPlayerMovementPhase::Walking && GetWorld()->GetTimeSeconds() >= DashReadyTime;
+}
+
 void AHypercubeCharacter::Dash()
 {
-	if (!bCanDash || MovementPhase != EPlayerMovementPhase::Walking)
+	if (!CanDash())
 	{
 		//UE_LOG(LogTemp, Warning, TEXT("Can not dash!"));
 		return;
 	}
-	PlayerActionDelegate.Broadcast(EPlayerAction::Dash);
 	FVector Forward = FollowCamera->GetForwardVector();
 	Forward.Z = 0.0f;
 	Forward.Normalize();
 	FVector Right = FollowCamera->GetRightVector();
 	Right.Z = 0.0f;
 	Right.Normalize();
-	DashDestination = Forward * InputComp->GetAxisValue(TEXT("MoveForward")) + Right * InputComp->GetAxisValue(TEXT("MoveRight"));
-	if (DashDestination.IsNearlyZero())
-	{
-		DashDestination = GetActorForwardVector();
-	}
-	else
+	DashTowards(Forward * LastMoveForward + Right * LastMoveRight);
+}
+
+void AHypercubeCharacter::DashTowards(FVector Direction)
+{
+	if (!CanDash())
 	{
-		DashDestination.Normalize();
+		return;
 	}
+	PlayerActionDelegate.Broadcast(EPlayerAction::Dash);
+	Direction.Z = 0.0f;
+	DashDestination = Direction.IsNearlyZero() ? GetActorForwardVector() : Direction.GetSafeNormal();
 	SetActorRotation(UKismetMathLibrary::MakeRotFromXZ(DashDestination, FVector::ZAxisVector));
+	SweepDashPath();
 	DashTimer = 0.0f;
+	HudModel->SetBar(EHudBar::Dash, GetWorld()->GetTimeSeconds(), DashTime, 1.0f, 0.0f);
 	MoveComp->SetMovementMode(EMovementMode::MOVE_None);
 	MovementPhase = EPlayerMovementPhase::Dashing;
-	bCanDash = false;
+	UpdateTickEnabled();
 	
 	Capsule->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECollisionResponse::ECR_Ignore);
 
@@ -358,6 +478,21 @@ void AHypercubeCharacter::Dash()
 	//}
 }
 
+// sweeps with the capsule's own channel and responses, so the path stops at whatever would block the capsule,
+// except pawns, which the capsule ignores during the dash
+void AHypercubeCharacter::SweepDashPath()
+{
+	const FVector Start = GetActorLocation();
+	const FVector End = Start + DashDestination * DashDistance;
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(HypercubeDash), false, this);
+	FCollisionResponseParams ResponseParams(Capsule->GetCollisionResponseToChannels());
+	ResponseParams.CollisionResponse.SetResponse(ECollisionChannel::ECC_Pawn, ECollisionResponse::ECR_Ignore);
+	FHitResult Hit;
+	const bool bHit = GetWorld()->SweepSingleByChannel(Hit, Start, End, Capsule->GetComponentQuat(),
+		Capsule->GetCollisionObjectType(), Capsule->GetCollisionShape(), Params, ResponseParams);
+	DashPath = (bHit ? Hit.Location : End) - Start;
+}
+
 void AHypercubeCharacter::AllowMovingWhileDash()
 {
 	bDashMovementBlocked = false;
@@ -371,33 +506,16 @@ void AHypercubeCharacter::StopDashing()
 	bDashMovementBlocked = true;
 	Capsule->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECollisionResponse::ECR_Block);
 	//UE_LOG(LogTemp, Warning, TEXT("End of dash"));
-	DashCooldownTimer = 0.0f;
-}
-
-void AHypercubeCharacter::OnEndDashCooldown()
-{
-	//UE_LOG(LogTemp, Warning, TEXT("End of dash cooldown"));
-	bCanDash = true;
+	DashReadyTime = GetWorld()->GetTimeSeconds() + DashCooldownTime;
+	HudModel->SetBar(EHudBar::Dash, GetWorld()->GetTimeSeconds(), DashCooldownTime, -0.1f, 0.9f);
+	UpdateTickEnabled();
 }
 
 void AHypercubeCharacter::SetAttackCollision(bool Activate)
 {
-	if (bDebug)
-	{
-		AttackCollision->SetVisibility(Activate);
-	}
 	AttackCollision->SetActive(Activate);
 }
 
-void AHypercubeCharacter::SetDebugAttackCollision(bool Activate)
-{
-	if (bDebug)
-	{
-		Debug_AttackCollision->SetVisibility(Activate);
-		Debug_AttackCollision->SetActive(Activate);
-	}
-}
-
 void AHypercubeCharacter::ReceiveAttackInput()
 {
 	if (MovementPhase != EPlayerMovementPhase::Walking)
@@ -415,25 +533,23 @@ void AHypercubeCharacter::Attack()
 	{
 	case EPlayerAttackPhase::None:
 		AttackPhase = EPlayerAttackPhase::Opener;
-		SetDebugAttackCollision(true);
 		GetWorld()->GetTimerManager().SetTimer(AttackTimerHandle, this, &AHypercubeCharacter::Attack, SimpleAttack.OpenerTime, false);
 		break;
 	case EPlayerAttackPhase::Opener:
 		AttackPhase = EPlayerAttackPhase::Attacking;
-		AttackEnemiesCollided.Empty();
-		SetDebugAttackCollision(false);
+		AttackEnemiesCollided.Reset(); // keeps the buckets for the next attack
 		SetAttackCollision(true);
+		UpdateTickEnabled();
 		GetWorld()->GetTimerManager().SetTimer(AttackTimerHandle, this, &AHypercubeCharacter::Attack, SimpleAttack.AttackTime, false);
 		break;
 	case EPlayerAttackPhase::Attacking:
 		AttackPhase = EPlayerAttackPhase::AfterAttack;
 		SetAttackCollision(false);
-		SetDebugAttackCollision(true);
+		UpdateTickEnabled();
 		GetWorld()->GetTimerManager().SetTimer(AttackTimerHandle, this, &AHypercubeCharacter::Attack, SimpleAttack.AfterAttackTime, false);
 		break;
 	case EPlayerAttackPhase::AfterAttack:
 		AttackPhase = EPlayerAttackPhase::None;
-		SetDebugAttackCollision(false);
 		OnEndAttack();
 	}
 }
@@ -446,35 +562,20 @@ void AHypercubeCharacter::OnEndAttack()
 	}
 }
 
-void AHypercubeCharacter::ActivateDebugDamageIndicator()
-{
-	Debug_DamageIndicator->SetVisibility(true);
-	if (GetWorld()->GetTimerManager().IsTimerActive(Debug_DamageIndicatorTimerHandle))
-	{
-		GetWorld()->GetTimerManager().ClearTimer(Debug_DamageIndicatorTimerHandle);
-	}
-	GetWorld()->GetTimerManager().SetTimer(Debug_DamageIndicatorTimerHandle, this, &AHypercubeCharacter::OnEndDebugDamageIndicatorTimer, Debug_DamageIndicatorTime, false);
-}
-
-void AHypercubeCharacter::OnEndDebugDamageIndicatorTimer()
-{
-	Debug_DamageIndicator->SetVisibility(false);
-}
-
 void AHypercubeCharacter::TakeDamage(float Damage)
 {
-	if (bIsInvincible)
+	if (bIsInvincible || bDebug_Invincible)
 	{
 		return;
 	}
 	Health -= Damage;
-	if (bDebug)
-	{
-		ActivateDebugDamageIndicator();
-	}
+	FHypercubeTrace::Damage(this, Damage, Health);
+	FHypercubeEventLog::Record(EHypercubeEvent::PlayerDamaged, this, Damage, Health);
+	HYPERCUBE_DEBUG_DAMAGE(this, bDebug, Debug_DamageIndicatorTime);
 	bIsInvincible = true;
 	//UE_LOG(LogTemp, Warning, TEXT("Damage: %f, Now Health: %f"), Damage, Health);
-	DamageFXTimer = DamageFXTime;
+	HudModel->SetValue(EHudValue::Health, Health);
+	HudModel->SetBar(EHudBar::DamageFX, GetWorld()->GetTimeSeconds(), DamageFXTime, 0.0f, 1.0f);
 	PlayerActionDelegate.Broadcast(EPlayerAction::Damaged);
 	if (Health <= 0.0f)
 	{
@@ -494,24 +595,33 @@ void AHypercubeCharacter::PlayDeath()
 	MovementPhase = EPlayerMovementPhase::None;
 	MoveComp->SetMovementMode(EMovementMode::MOVE_None);
 	bCanDash = false;
+	UpdateTickEnabled();
 	LevelController->OnPlayerDeath();
 	PlayerDeathDelegate.Broadcast();
 }
 
 void AHypercubeCharacter::UpdateDamageMultiplier()
 {
-	TargetDamageMultiplier = 1.0f + DamageMultiplierEnemyCost * EnemyChasing.Num();
+	DamageMultiplier = GetDamageMultiplier();
+	TargetDamageMultiplier = 1.0f + DamageMultiplierEnemyCost * GetEnemyChasingCount();
 	if (TargetDamageMultiplier >= DamageMultiplier)
 	{
 		if (GetWorld()->GetTimerManager().IsTimerActive(DamageMultiplierStaysTimerHandle))
 		{
 			GetWorld()->GetTimerManager().ClearTimer(DamageMultiplierStaysTimerHandle);
 		}
+		GetWorld()->GetTimerManager().ClearTimer(DamageMultiplierFallTimerHandle);
 		DamageMultiplier = TargetDamageMultiplier;
+		HudModel->SetValue(EHudValue::DamageMultiplier, DamageMultiplier);
+		HudModel->SetBar(EHudBar::DamageMultiplier, GetWorld()->GetTimeSeconds(), 0.0f, DamageMultiplier, DamageMultiplier);
+	}
+	else if (bDamageMultiplierFalling)
+	{
+		StartDamageMultiplierFall(); // the target moved, the decay goes on from the current value
 	}
 	else
 	{
-		if (!GetWorld()->GetTimerManager().IsTimerActive(DamageMultiplierStaysTimerHandle) && !bDamageMultiplierFalling)
+		if (!GetWorld()->GetTimerManager().IsTimerActive(DamageMultiplierStaysTimerHandle))
 		{
 			GetWorld()->GetTimerManager().SetTimer(DamageMultiplierStaysTimerHandle, this, &AHypercubeCharacter::OnEndDamageMultiplierStays, DamageMultiplierStaysTime, false);
 			bDamageMultiplierStays = true;
@@ -522,32 +632,84 @@ void AHypercubeCharacter::UpdateDamageMultiplier()
 void AHypercubeCharacter::OnEndDamageMultiplierStays()
 {
 	bDamageMultiplierStays = false;
+	DamageMultiplierFallFrom = DamageMultiplier;
+	DamageMultiplierFallStart = GetWorld()->GetTimeSeconds();
 	bDamageMultiplierFalling = true;
+	StartDamageMultiplierFall();
+}
+
+// the decay is linear, so only its start is stored and a timer settles it when it reaches the target
+void AHypercubeCharacter::StartDamageMultiplierFall()
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+	DamageMultiplier = DamageMultiplierFallFrom = GetDamageMultiplier();
+	DamageMultiplierFallStart = Now;
+	const float Duration = DamageMultiplierDecreaseSpeed > 0.0f ? (DamageMultiplier - TargetDamageMultiplier) / DamageMultiplierDecreaseSpeed : 0.0f;
+	if (Duration > 0.0f)
+	{
+		GetWorld()->GetTimerManager().SetTimer(DamageMultiplierFallTimerHandle, this, &AHypercubeCharacter::OnEndDamageMultiplierFall, Duration, false);
+		HudModel->SetBar(EHudBar::DamageMultiplier, Now, Duration, DamageMultiplier, TargetDamageMultiplier);
+	}
+	else if (DamageMultiplierDecreaseSpeed > 0.0f)
+	{
+		OnEndDamageMultiplierFall();
+	}
+}
+
+void AHypercubeCharacter::OnEndDamageMultiplierFall()
+{
+	DamageMultiplier = TargetDamageMultiplier;
+	bDamageMultiplierFalling = false;
+	HudModel->SetValue(EHudValue::DamageMultiplier, DamageMultiplier);
+}
+
+float AHypercubeCharacter::GetDamageMultiplier() const
+{
+	if (!bDamageMultiplierFalling || DamageMultiplierFallFrom <= TargetDamageMultiplier)
+	{
+		return DamageMultiplier;
+	}
+	const float Elapsed = GetWorld()->GetTimeSeconds() - DamageMultiplierFallStart;
+	return FMath::Max(TargetDamageMultiplier, DamageMultiplierFallFrom - DamageMultiplierDecreaseSpeed * Elapsed);
 }
 
 void AHypercubeCharacter::OnEnemyAggro(class ABase_NPC_SimpleChase* Enemy)
 {
-	if (!EnemyChasing.Contains(Enemy))
+	if (LevelController && LevelController->GetEnemyRegistry().SetChasing(Enemy->RegistryHandle, true))
 	{
-		EnemyChasing.Add(Enemy);
 		UpdateDamageMultiplier();
+		EnemyChasingCountChangedDelegate.Broadcast(GetEnemyChasingCount());
 	}
 }
 
 void AHypercubeCharacter::OnEnemyDeath(class ABase_NPC_SimpleChase* Enemy)
 {
-	Score += BaseScoreForEnemy * DamageMultiplier;
-	Health += Vampirism * Enemy->MaxHealth;
-	Health = Health > MaxHealth ? MaxHealth : Health;
-	if (LevelController)
+	OnEnemiesDeath(MakeArrayView(&Enemy, 1));
+}
+
+void AHypercubeCharacter::OnEnemiesDeath(TArrayView<class ABase_NPC_SimpleChase* const> Enemies)
+{
+	const float Multiplier = GetDamageMultiplier();
+	float Healed = 0.0f;
+	bool bAnyChasing = false;
+	for (ABase_NPC_SimpleChase* Enemy : Enemies)
 	{
-		LevelController->RemoveEnemy(Enemy);
-		LevelController->UpdateMaxMultiplicator(DamageMultiplier);
+		Healed += Vampirism * Enemy->MaxHealth;
+		bAnyChasing |= LevelController && LevelController->GetEnemyRegistry().IsChasing(Enemy->RegistryHandle);
 	}
-	if (EnemyChasing.Contains(Enemy))
+	Score += BaseScoreForEnemy * Multiplier * Enemies.Num();
+	Health = FMath::Min(Health + Healed, MaxHealth);
+	HudModel->SetValue(EHudValue::Score, Score);
+	HudModel->SetValue(EHudValue::Health, Health);
+	if (LevelController)
 	{
-		EnemyChasing.Remove(Enemy);
-		UpdateDamageMultiplier();
+		LevelController->RemoveEnemies(Enemies);
+		LevelController->UpdateMaxMultiplicator(Multiplier);
+		if (bAnyChasing)
+		{
+			UpdateDamageMultiplier();
+			EnemyChasingCountChangedDelegate.Broadcast(GetEnemyChasingCount());
+		}
 	}
 }
 
@@ -581,7 +743,19 @@ ABase_LevelController* AHypercubeCharacter::GetLevelController() const
 
 int AHypercubeCharacter::GetEnemyChasingCount() const
 {
-	return EnemyChasing.Num();
+	return LevelController ? LevelController->GetEnemyRegistry().GetChasingCount() : 0;
+}
+
+// the HUD values are evaluated from the HUD model's timestamps when read, nothing is written per frame
+float AHypercubeCharacter::GetDashBarPercentage() const
+{
+	return HudModel->GetBarValue(EHudBar::Dash, GetWorld()->GetTimeSeconds());
+}
+
+float AHypercubeCharacter::GetDamageFXAlpha() const
+{
+	const float Time = GetWorld()->GetTimeSeconds();
+	return Time < HudModel->GetBar(EHudBar::DamageFX).EndTime ? DamageFXCurve(HudModel->GetBarValue(EHudBar::DamageFX, Time)) : 0.0f;
 }
 
 void AHypercubeCharacter::SetSpeedBuff(float SpeedMult, float JumpMult, float Time)
@@ -598,7 +772,7 @@ void AHypercubeCharacter::SetSpeedBuff(float SpeedMult, float JumpMult, float Ti
 
 		MoveComp->MaxWalkSpeed *= SpeedMult;
 		MoveComp->JumpZVelocity *= JumpMult;
-		TargetCameraFov *= 1.3f;
+		SetTargetCameraFov(TargetCameraFov * 1.3f);
 
 		SpeedBuffEffectWidget->SetVisibility(true);
 	}
@@ -609,6 +783,41 @@ void AHypercubeCharacter::OnEndSpeedBuff()
 {
 	MoveComp->MaxWalkSpeed = BaseSpeed;
 	MoveComp->JumpZVelocity = BaseJumpVelocity;
-	TargetCameraFov = BaseCameraFov;
+	SetTargetCameraFov(BaseCameraFov);
 	SpeedBuffEffectWidget->SetVisibility(false);
 }
+
+void AHypercubeCharacter::SetTargetCameraFov(float Fov)
+{
+	CameraFovFrom = GetCameraFov();
+	CameraFovChangeStart = GetWorld()->GetTimeSeconds();
+	TargetCameraFov = Fov;
+}
+
+// the exponential the old per-frame lerp approximated, evaluated when the camera manager asks for the view
+float AHypercubeCharacter::GetCameraFov() const
+{
+	const float Elapsed = GetWorld()->GetTimeSeconds() - CameraFovChangeStart;
+	const float Fov = TargetCameraFov + (CameraFovFrom - TargetCameraFov) * FMath::Exp(-CameraFovChangeSpeed * Elapsed);
+	return FMath::IsNearlyEqual(Fov, TargetCameraFov, 0.001f) ? TargetCameraFov : Fov;
+}
+
+void AHypercubeCharacter::CalcCamera(float DeltaTime, FMinimalViewInfo& OutResult)
+{
+	Super::CalcCamera(DeltaTime, OutResult);
+	OutResult.FOV = GetCameraFov();
+	FollowCamera->FieldOfView = OutResult.FOV; // still read by blueprints
+}
+
+int AHypercubeCharacter::CountActiveTimers() const
+{
+	const FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+	const FTimerHandle* Handles[] = { &InvincTimerHandle, &DamageMultiplierStaysTimerHandle, &DamageMultiplierFallTimerHandle,
+		&AttackTimerHandle, &SpeedBuffTimerHandle };
+	int Count = 0;
+	for (const FTimerHandle* Handle : Handles)
+	{
+		Count += TimerManager.IsTimerActive(*Handle) ? 1 : 0;
+	}
+	return Count;
+}
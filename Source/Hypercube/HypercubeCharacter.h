@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "Base_DamageQueue.h"
 #include "HypercubeCharacter.generated.h"
 
 UENUM(BlueprintType)
@@ -62,6 +63,7 @@ struct FPlayerAttackStats
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnPlayerAction, EPlayerAction, Action);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnPlayerDeath);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnPause, bool, bIsPaused);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnEnemyChasingCountChanged, int);
 
 UCLASS(config = Game)
 class AHypercubeCharacter : public ACharacter
@@ -82,10 +84,12 @@ class AHypercubeCharacter : public ACharacter
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	class UBoxComponent* AttackCollision;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
+	// Editor-only and never registered, kept so blueprints that still reference them load; null in cooked builds.
+	// Debug drawing is done by FGameplayDebugDraw
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true", DeprecatedProperty, DeprecationMessage = "Debug drawing moved to the level subsystem, see hypercube.DebugDraw"))
 	class UBoxComponent* Debug_AttackCollision;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true", DeprecatedProperty, DeprecationMessage = "Debug drawing moved to the level subsystem, see hypercube.DebugDraw"))
 	class UStaticMeshComponent* Debug_DamageIndicator;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
@@ -109,6 +113,8 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = EventDispatchers)
 	FOnPause PauseDelegate;
 
+	FOnEnemyChasingCountChanged EnemyChasingCountChangedDelegate;
+
 	/** Base turn rate, in deg/sec. Other scaling may affect final turn rate. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera)
 	float BaseTurnRate;
@@ -156,7 +162,8 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats | Attack | Damage Multiplying")
 	float DamageMultiplierDecreaseSpeed;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Stats | Attack | Damage Multiplying")
+	// value at the last change, GetDamageMultiplier includes the decay since then
+	UPROPERTY(VisibleAnywhere, Category = "Stats | Attack | Damage Multiplying")
 	float DamageMultiplier;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Stats | Attack | Damage Multiplying")
@@ -171,21 +178,21 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Debug")
 	float Debug_DamageIndicatorTime;
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Debug")
+	bool bDebug_Invincible;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "State")
 	bool bIsGamePaused;
 
+	UPROPERTY(VisibleAnywhere, Instanced, BlueprintReadOnly, Category = "UI")
+	class UBase_HudModel* HudModel;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UI")
 	float DamageFXTime;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "UI")
-	float DamageFXAlpha;
-
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera")
 	float CameraFovChangeSpeed;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "UI")
-	float DashBarPercentage;
-
 	UPROPERTY(BlueprintReadOnly, Category = "State")
 	EPlayerMovementPhase MovementPhase;
 
@@ -196,34 +203,39 @@ protected:
 
 	class UCharacterMovementComponent* MoveComp;
 	class UInputComponent* InputComp;
+	class UBase_InputRecorderComponent* InputRecorder;
 
-	bool bCanDash;
+	float LastMoveForward;
+	float LastMoveRight;
+
+	bool bCanDash; // false after death, the cooldown is DashReadyTime
 	bool bDashMovementBlocked;
 	FVector DashDestination;
+	FVector DashPath; // swept once at dash start, from the start location to the first blocker of the capsule
 	float DashTimer;
-	float DashCooldownTimer;
+	float DashReadyTime;
 
 	bool bIsInvincible;
 	FTimerHandle InvincTimerHandle;
 
 	bool bDamageMultiplierStays;
 	bool bDamageMultiplierFalling;
+	float DamageMultiplierFallStart;
+	float DamageMultiplierFallFrom;
 	FTimerHandle DamageMultiplierStaysTimerHandle;
+	FTimerHandle DamageMultiplierFallTimerHandle;
 
 	FTimerHandle AttackTimerHandle;
 
 	TSet<class ABase_NPC_SimpleChase*> AttackEnemiesCollided;
-
-	TSet<class ABase_NPC_SimpleChase*> EnemyChasing;
-
-	float DamageFXTimer;
-
-	FTimerHandle Debug_DamageIndicatorTimerHandle;
+	FDamageQueue DamageQueue;
 
 	float BaseSpeed;
 	float BaseJumpVelocity;
 	float BaseCameraFov;
 	float TargetCameraFov;
+	float CameraFovFrom;
+	float CameraFovChangeStart;
 	FTimerHandle SpeedBuffTimerHandle;
 
 protected:
@@ -234,22 +246,35 @@ protected:
 
 	void MoveForward(float Value);
 	void MoveRight(float Value);
-
-	inline float DashVelocityCurve(float x); // f(x) where int_0^1(f(x))dx = 1
-	inline float DamageFXCurve(float x);
-
+	void Turn(float Value);
+	void LookUp(float Value);
+	void OnJumpPressed();
+	void OnJumpReleased();
+	void OnDashPressed();
+	void OnAttackPressed();
+
+	static float DashDistanceCurve(float x); // share of the path covered, int_0^x(f(t))dt of the velocity curve f(t) = pi/2 * sin(pi * t)
+	static float DamageFXCurve(float x);
+
+	bool CanDash() const;
+	void SweepDashPath();
 	void Dash();
 	void AllowMovingWhileDash();
 	void StopDashing();
-	void OnEndDashCooldown();
 
 	void SetAttackCollision(bool Activate);
-	void SetDebugAttackCollision(bool Activate);
 	void Attack();
 	void OnEndAttack();
 
-	void ActivateDebugDamageIndicator();
-	void OnEndDebugDamageIndicatorTimer();
+	// the character ticks only while dashing or while the attack collision is active, HUD values are evaluated when read
+	void UpdateTickEnabled();
+
+	void StartDamageMultiplierFall();
+	void OnEndDamageMultiplierFall();
+
+	void SetTargetCameraFov(float Fov);
+	float GetCameraFov() const;
+	virtual void CalcCamera(float DeltaTime, struct FMinimalViewInfo& OutResult) override;
 
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 	virtual void BeginPlay() override;
@@ -257,12 +282,15 @@ protected:
 
 	void DashTick(float DeltaSeconds);
 	void AttackTick();
+	void ResolveDamage();
 
 public:
 	/** Returns CameraBoom subobject **/
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	/** Returns FollowCamera subobject **/
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
+	/** Returns AttackCollision subobject **/
+	FORCEINLINE class UBoxComponent* GetAttackCollision() const { return AttackCollision; }
 
 	UFUNCTION(BlueprintCallable)
 	void TakeDamage(float Damage);
@@ -278,12 +306,18 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void OnEndDamageMultiplierStays();
 
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	float GetDamageMultiplier() const;
+
 	UFUNCTION(BlueprintCallable)
 	void OnEnemyAggro(class ABase_NPC_SimpleChase* Enemy);
 
 	UFUNCTION(BlueprintCallable)
 	void OnEnemyDeath(class ABase_NPC_SimpleChase* Enemy);
 
+	// everything a kill changes, computed once for all enemies killed in a frame
+	void OnEnemiesDeath(TArrayView<class ABase_NPC_SimpleChase* const> Enemies);
+
 	UFUNCTION(BlueprintCallable)
 	void SetMouseCursorShow(bool Activate);
 
@@ -296,12 +330,27 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void ReceiveAttackInput();
 
+	// dash in a world direction, falls back to the facing direction for a zero vector
+	UFUNCTION(BlueprintCallable)
+	void DashTowards(FVector Direction);
+
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	int GetEnemyChasingCount() const;
 
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	float GetDashBarPercentage() const;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	float GetDamageFXAlpha() const;
+
 	UFUNCTION(BlueprintCallable)
 	void SetSpeedBuff(float SpeedMult, float JumpMult, float Time);
 
 	void OnEndSpeedBuff();
+
+	void SetInputRecorder(class UBase_InputRecorderComponent* Recorder);
+	void ApplyReplayInput(const struct FInputFrame& Frame);
+
+	int CountActiveTimers() const; // for stat Hypercube
 };
 
@@ -0,0 +1,115 @@
+#include "HypercubeEventLog.h"
+#include "Hypercube.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformTLS.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/DateTime.h"
+#include "Serialization/MemoryWriter.h"
+#include <atomic>
+
+namespace
+{
+	const uint32 EventLogMagic = 0x56454348; // "HCEV"
+	const int32 EventLogVersion = 1;
+
+	struct FThreadRing
+	{
+		FThreadRing* Next;
+		uint32 ThreadId;
+		std::atomic<uint64> Written; // only the owning thread writes
+		FHypercubeEvent Events[FHypercubeEventLog::EventsPerThread];
+	};
+
+	// rings are pushed once per thread and never freed, so a dump can walk them at any time
+	std::atomic<FThreadRing*> RingHead(nullptr);
+	thread_local FThreadRing* LocalRing = nullptr;
+
+	FDelegateHandle SystemErrorHandle;
+
+	FThreadRing* CreateLocalRing()
+	{
+		FThreadRing* Ring = new FThreadRing();
+		Ring->ThreadId = FPlatformTLS::GetCurrentThreadId();
+		Ring->Written.store(0, std::memory_order_relaxed);
+		FThreadRing* Head = RingHead.load(std::memory_order_relaxed);
+		do
+		{
+			Ring->Next = Head;
+		} while (!RingHead.compare_exchange_weak(Head, Ring, std::memory_order_release, std::memory_order_relaxed));
+		return Ring;
+	}
+
+	FAutoConsoleCommand DumpEventsCommand(
+		TEXT("Hypercube.DumpEvents"),
+		TEXT("Writes the in-memory gameplay event rings to Saved/Events"),
+		FConsoleCommandDelegate::CreateLambda([]() { FHypercubeEventLog::Dump(TEXT("Manual")); }));
+}
+
+static_assert(sizeof(FHypercubeEvent) == 32, "FHypercubeEvent is written to disk as is");
+
+void FHypercubeEventLog::Record(EHypercubeEvent Type, const UObject* Object, float A, float B, float C, float D)
+{
+	FThreadRing* Ring = LocalRing;
+	if (!Ring)
+	{
+		Ring = LocalRing = CreateLocalRing();
+	}
+	const uint64 Index = Ring->Written.load(std::memory_order_relaxed);
+	FHypercubeEvent& Event = Ring->Events[Index % EventsPerThread];
+	Event.Cycles = FPlatformTime::Cycles64();
+	Event.ObjectId = Object ? Object->GetUniqueID() : 0;
+	Event.Type = Type;
+	Event.Data[0] = A;
+	Event.Data[1] = B;
+	Event.Data[2] = C;
+	Event.Data[3] = D;
+	Ring->Written.store(Index + 1, std::memory_order_release);
+}
+
+FString FHypercubeEventLog::Dump(const TCHAR* Reason)
+{
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+	uint32 Magic = EventLogMagic;
+	int32 Version = EventLogVersion;
+	double SecondsPerCycle = FPlatformTime::GetSecondsPerCycle64();
+	int32 RingCount = 0;
+	for (FThreadRing* Ring = RingHead.load(std::memory_order_acquire); Ring; Ring = Ring->Next)
+	{
+		++RingCount;
+	}
+	if (!RingCount)
+	{
+		return FString();
+	}
+	Writer << Magic << Version << SecondsPerCycle << RingCount;
+	for (FThreadRing* Ring = RingHead.load(std::memory_order_acquire); Ring; Ring = Ring->Next)
+	{
+		const uint64 Written = Ring->Written.load(std::memory_order_acquire);
+		const uint64 First = Written > EventsPerThread ? Written - EventsPerThread : 0;
+		uint32 ThreadId = Ring->ThreadId;
+		uint32 Count = uint32(Written - First);
+		Writer << ThreadId << Count;
+		for (uint64 i = First; i < Written; ++i)
+		{
+			Writer.Serialize(&Ring->Events[i % EventsPerThread], sizeof(FHypercubeEvent));
+		}
+	}
+	const FString Path = FPaths::ProjectSavedDir() / TEXT("Events") / FString::Printf(TEXT("%s-%s.hcev"), Reason, *FDateTime::Now().ToString());
+	FFileHelper::SaveArrayToFile(Data, *Path);
+	UE_LOG(LogHypercube, Log, TEXT("Gameplay events dumped to %s"), *Path);
+	return Path;
+}
+
+void FHypercubeEventLog::Startup()
+{
+	SystemErrorHandle = FCoreDelegates::OnHandleSystemError.AddLambda([]() { FHypercubeEventLog::Dump(TEXT("Crash")); });
+}
+
+void FHypercubeEventLog::Shutdown()
+{
+	FCoreDelegates::OnHandleSystemError.Remove(SystemErrorHandle);
+}
@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EHypercubeEvent : uint8
+{
+	LevelBegin,		// Data: level index, difficulty parameter
+	EnemiesSpawned,	// Data: spawned, wanted
+	EnemyPhase,		// Data: old phase, new phase
+	EnemyAttack,	// recorded when an attack starts, no data
+	EnemyJump,		// Data: destination xyz
+	EnemyLanded,
+	EnemyDamaged,	// Data: damage, health left
+	PlayerDamaged,	// Data: damage, health left
+	Hitch,			// Data: frame ms
+	Count
+};
+
+// 32 bytes, Cycles is FPlatformTime::Cycles64
+struct FHypercubeEvent
+{
+	uint64 Cycles;
+	uint32 ObjectId;
+	EHypercubeEvent Type;
+	uint8 Pad[3];
+	float Data[4];
+};
+
+// Structured gameplay events kept in memory instead of being formatted into the log.
+// Every thread writes its own ring of EventsPerThread events without locks; a dump copies the rings to
+// Saved/Events/<Reason>-<Time>.hcev on demand (Hypercube.DumpEvents), on a system error or from the hitch detector.
+// File: magic 'HCEV', version, seconds per cycle (double), ring count, then per ring: thread id, event count, events oldest first.
+// Events written while a dump runs can come out torn, which is fine for diagnostics.
+struct HYPERCUBE_API FHypercubeEventLog
+{
+	static const uint32 EventsPerThread = 4096;
+
+	static void Record(EHypercubeEvent Type, const UObject* Object, float A = 0.0f, float B = 0.0f, float C = 0.0f, float D = 0.0f);
+
+	// returns the written file, empty if nothing was recorded
+	static FString Dump(const TCHAR* Reason);
+
+	static void Startup();
+	static void Shutdown();
+};
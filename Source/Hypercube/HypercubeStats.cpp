@@ -0,0 +1,69 @@
+#include "HypercubeStats.h"
+#include "GameFramework/Actor.h"
+#include "Trace/Trace.inl"
+
+DEFINE_STAT(STAT_Hypercube_PlayerTick);
+DEFINE_STAT(STAT_Hypercube_AttackTick);
+DEFINE_STAT(STAT_Hypercube_ResolveDamage);
+DEFINE_STAT(STAT_Hypercube_EnemyTick);
+DEFINE_STAT(STAT_Hypercube_CheckPlayerHit);
+DEFINE_STAT(STAT_Hypercube_Unstuck);
+DEFINE_STAT(STAT_Hypercube_PlayerHasSightOn);
+DEFINE_STAT(STAT_Hypercube_SpawnEnemies);
+DEFINE_STAT(STAT_Hypercube_SaveLevelData);
+DEFINE_STAT(STAT_Hypercube_Scoreboard);
+DEFINE_STAT(STAT_Hypercube_DifficultyCompile);
+DEFINE_STAT(STAT_Hypercube_DifficultyEvaluate);
+
+DEFINE_STAT(STAT_Hypercube_EnemiesIdle);
+DEFINE_STAT(STAT_Hypercube_EnemiesNoticing);
+DEFINE_STAT(STAT_Hypercube_EnemiesChasing);
+DEFINE_STAT(STAT_Hypercube_TickingEnemies);
+DEFINE_STAT(STAT_Hypercube_ActiveTimers);
+DEFINE_STAT(STAT_Hypercube_OverlapQueries);
+DEFINE_STAT(STAT_Hypercube_OverlappingActors);
+DEFINE_STAT(STAT_Hypercube_GameplayAllocs);
+
+bool FGameplayFrameCounters::bTimeSystems = false;
+uint32 FGameplayFrameCounters::OverlapQueries = 0;
+uint64 FGameplayFrameCounters::SystemCycles[int(EGameplaySystem::Count)] = {};
+
+void FGameplayFrameCounters::Reset()
+{
+	OverlapQueries = 0;
+	FMemory::Memzero(SystemCycles);
+}
+
+UE_TRACE_CHANNEL_DEFINE(HypercubeChannel);
+
+UE_TRACE_EVENT_BEGIN(Hypercube, EnemyPhase)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, EnemyId)
+	UE_TRACE_EVENT_FIELD(uint8, OldPhase)
+	UE_TRACE_EVENT_FIELD(uint8, NewPhase)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Hypercube, Damage)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, TargetId)
+	UE_TRACE_EVENT_FIELD(float, Amount)
+	UE_TRACE_EVENT_FIELD(float, HealthLeft)
+UE_TRACE_EVENT_END()
+
+void FHypercubeTrace::EnemyPhase(const class AActor* Enemy, uint8 OldPhase, uint8 NewPhase)
+{
+	UE_TRACE_LOG(Hypercube, EnemyPhase, HypercubeChannel)
+		<< EnemyPhase.Cycle(FPlatformTime::Cycles64())
+		<< EnemyPhase.EnemyId(Enemy->GetUniqueID())
+		<< EnemyPhase.OldPhase(OldPhase)
+		<< EnemyPhase.NewPhase(NewPhase);
+}
+
+void FHypercubeTrace::Damage(const class AActor* Target, float Amount, float HealthLeft)
+{
+	UE_TRACE_LOG(Hypercube, Damage, HypercubeChannel)
+		<< Damage.Cycle(FPlatformTime::Cycles64())
+		<< Damage.TargetId(Target->GetUniqueID())
+		<< Damage.Amount(Amount)
+		<< Damage.HealthLeft(HealthLeft);
+}
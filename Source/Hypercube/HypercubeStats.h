@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "HAL/PlatformTime.h"
+
+// stat Hypercube in the console, or the Hypercube group in a stats capture
+DECLARE_STATS_GROUP(TEXT("Hypercube"), STATGROUP_Hypercube, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Player Tick"), STAT_Hypercube_PlayerTick, STATGROUP_Hypercube, HYPERCUBE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Player AttackTick"), STAT_Hypercube_AttackTick, STATGROUP_Hypercube, HYPERCUBE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Player ResolveDamage"), STAT_Hypercube_ResolveDamage, STATGROUP_Hypercube, HYPERCUBE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Enemy Tick"), STAT_Hypercube_EnemyTick, STATGROUP_Hypercube, HYPERCUBE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Enemy CheckPlayerHit"), STAT_Hypercube_CheckPlayerHit, STATGROUP_Hypercube, HYPERCUBE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Enemy Unstuck"), STAT_Hypercube_Unstuck, STATGROUP_Hypercube, HYPERCUBE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Enemy PlayerHasSightOn"), STAT_Hypercube_PlayerHasSightOn, STATGROUP_Hypercube, HYPERCUBE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("SpawnEnemies"), STAT_Hypercube_SpawnEnemies, STATGROUP_Hypercube, HYPERCUBE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("SaveLevelData"), STAT_Hypercube_SaveLevelData, STATGROUP_Hypercube, HYPERCUBE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Scoreboard"), STAT_Hypercube_Scoreboard, STATGROUP_Hypercube, HYPERCUBE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Difficulty Compile"), STAT_Hypercube_DifficultyCompile, STATGROUP_Hypercube, HYPERCUBE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Difficulty Evaluate"), STAT_Hypercube_DifficultyEvaluate, STATGROUP_Hypercube, HYPERCUBE_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Enemies Idle"), STAT_Hypercube_EnemiesIdle, STATGROUP_Hypercube, HYPERCUBE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Enemies Noticing"), STAT_Hypercube_EnemiesNoticing, STATGROUP_Hypercube, HYPERCUBE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Enemies Chasing"), STAT_Hypercube_EnemiesChasing, STATGROUP_Hypercube, HYPERCUBE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Ticking Enemies"), STAT_Hypercube_TickingEnemies, STATGROUP_Hypercube, HYPERCUBE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Active Gameplay Timers"), STAT_Hypercube_ActiveTimers, STATGROUP_Hypercube, HYPERCUBE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Overlap Queries"), STAT_Hypercube_OverlapQueries, STATGROUP_Hypercube, HYPERCUBE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Overlapping Actors"), STAT_Hypercube_OverlappingActors, STATGROUP_Hypercube, HYPERCUBE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Gameplay Allocations"), STAT_Hypercube_GameplayAllocs, STATGROUP_Hypercube, HYPERCUBE_API);
+
+// -trace=cpu,hypercube adds enemy phase changes and damage events to Insights captures
+UE_TRACE_CHANNEL_EXTERN(HypercubeChannel, HYPERCUBE_API);
+
+struct HYPERCUBE_API FHypercubeTrace
+{
+	static void EnemyPhase(const class AActor* Enemy, uint8 OldPhase, uint8 NewPhase);
+	static void Damage(const class AActor* Target, float Amount, float HealthLeft);
+};
+
+enum class EGameplaySystem : uint8
+{
+	Enemies,
+	Player,
+	Audio,
+	Spawning,
+	Saving, // game thread only, the file writes finish in the background
+	Difficulty,
+	Scoreboard,
+	Count
+};
+
+// Frame counters for the gameplay overlay that work without the stats system, reset by the level subsystem every frame.
+// System times are only taken while the overlay is shown.
+struct HYPERCUBE_API FGameplayFrameCounters
+{
+	static bool bTimeSystems;
+	static uint32 OverlapQueries;
+	static uint64 SystemCycles[int(EGameplaySystem::Count)];
+
+	static void Reset();
+};
+
+struct FGameplaySystemScope
+{
+	explicit FGameplaySystemScope(EGameplaySystem InSystem)
+		: System(InSystem)
+		, StartCycles(FGameplayFrameCounters::bTimeSystems ? FPlatformTime::Cycles64() : 0)
+	{
+	}
+
+	~FGameplaySystemScope()
+	{
+		if (StartCycles)
+		{
+			FGameplayFrameCounters::SystemCycles[int(System)] += FPlatformTime::Cycles64() - StartCycles;
+		}
+	}
+
+	EGameplaySystem System;
+	uint64 StartCycles;
+};
+
+#define GAMEPLAY_SYSTEM_SCOPE(System) FGameplaySystemScope GameplaySystemScope(EGameplaySystem::System)
@@ -0,0 +1,145 @@
+#include "HypercubeAllocTracker.h"
+#include "Modules/ModuleManager.h"
+
+#if HYPERCUBE_ALLOC_TRACKING
+
+#include "HAL/MemoryBase.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogHypercubeAllocHook, Log, All);
+
+namespace
+{
+	// only touched on the game thread
+	int32 ScopeDepth = 0;
+	uint32 FrameAllocs = 0;
+	uint32 LastFrameAllocs = 0;
+	bool bInstalled = false;
+
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+
+		explicit FCountingMalloc(FMalloc* InInner)
+			: Inner(InInner)
+		{
+		}
+
+		virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+		{
+			Count();
+			return Inner->Malloc(Size, Alignment);
+		}
+
+		virtual void* Realloc(void* Ptr, SIZE_T NewSize, uint32 Alignment) override
+		{
+			if (NewSize)
+			{
+				Count();
+			}
+			return Inner->Realloc(Ptr, NewSize, Alignment);
+		}
+
+		virtual void Free(void* Ptr) override
+		{
+			Inner->Free(Ptr);
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void InitializeStatsMetadata() override { Inner->InitializeStatsMetadata(); }
+		virtual void UpdateStats() override { Inner->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+	private:
+
+		FMalloc* Inner;
+
+		static void Count()
+		{
+			if (ScopeDepth > 0 && IsInGameThread())
+			{
+				++FrameAllocs;
+			}
+		}
+	};
+}
+
+// everything keeps going through the wrapped allocator, so memory allocated before the swap is freed correctly.
+// Called from PostConfigInit while only the main thread runs, the atomic swap just keeps the pointer publish well defined.
+void FHypercubeAllocTracker::Install()
+{
+	if (bInstalled || !GMalloc)
+	{
+		return;
+	}
+	FMalloc* Wrapper = new FCountingMalloc(GMalloc);
+	FPlatformAtomics::InterlockedExchangePtr((void**)&GMalloc, Wrapper);
+	bInstalled = true;
+	UE_LOG(LogHypercubeAllocHook, Warning, TEXT("Gameplay allocation tracking enabled"));
+}
+
+bool FHypercubeAllocTracker::IsInstalled()
+{
+	return bInstalled;
+}
+
+void FHypercubeAllocTracker::EndFrame()
+{
+	LastFrameAllocs = FrameAllocs;
+	FrameAllocs = 0;
+}
+
+uint32 FHypercubeAllocTracker::GetLastFrameAllocs()
+{
+	return LastFrameAllocs;
+}
+
+FHypercubeAllocTracker::FScope::FScope()
+{
+	++ScopeDepth;
+}
+
+FHypercubeAllocTracker::FScope::~FScope()
+{
+	--ScopeDepth;
+}
+
+#endif
+
+class FHypercubeAllocHookModule : public IModuleInterface
+{
+public:
+
+	virtual void StartupModule() override
+	{
+#if HYPERCUBE_ALLOC_TRACKING
+		if (FParse::Param(FCommandLine::Get(), TEXT("HypercubeAllocTracking")))
+		{
+			FHypercubeAllocTracker::Install();
+			EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&FHypercubeAllocTracker::EndFrame);
+		}
+#endif
+	}
+
+	virtual void ShutdownModule() override
+	{
+#if HYPERCUBE_ALLOC_TRACKING
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+#endif
+	}
+
+private:
+
+	FDelegateHandle EndFrameHandle;
+};
+
+IMPLEMENT_MODULE(FHypercubeAllocHookModule, HypercubeAllocHook);
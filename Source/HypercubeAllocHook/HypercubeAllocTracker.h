@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#define HYPERCUBE_ALLOC_TRACKING !UE_BUILD_SHIPPING
+
+#if HYPERCUBE_ALLOC_TRACKING
+
+// Counts heap allocations made on the game thread inside HYPERCUBE_ALLOC_SCOPE, i.e. by the gameplay hot paths.
+// -HypercubeAllocTracking wraps GMalloc when the HypercubeAllocHook module starts up. The module loads in PostConfigInit,
+// before the engine starts its worker threads, so every allocation after that goes through the wrapper. The wrapper only
+// counts and forwards to the allocator it wraps, so blocks allocated before the swap are freed by the same allocator.
+// Without the switch GMalloc is never touched and the scopes cost one increment.
+// The per-frame count shows up as Gameplay Allocations in stat Hypercube and is checked by the scaling benchmark.
+struct HYPERCUBEALLOCHOOK_API FHypercubeAllocTracker
+{
+	static void Install();
+	static bool IsInstalled();
+
+	static void EndFrame();
+	static uint32 GetLastFrameAllocs();
+
+	struct HYPERCUBEALLOCHOOK_API FScope
+	{
+		FScope();
+		~FScope();
+	};
+};
+
+#define HYPERCUBE_ALLOC_SCOPE() FHypercubeAllocTracker::FScope HypercubeAllocScope
+
+#else
+
+#define HYPERCUBE_ALLOC_SCOPE()
+
+#endif
@@ -9,6 +9,6 @@ public class HypercubeEditorTarget : TargetRules
 	{
 		Type = TargetType.Editor;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
-		ExtraModuleNames.Add("Hypercube");
+		ExtraModuleNames.AddRange(new string[] { "Hypercube", "HypercubeAllocHook" });
 	}
 }